@@ -0,0 +1,349 @@
+// Генератор нагрузки на игровой сервер: подключает игроков и по keep-alive соединениям
+// шлёт смесь запросов action/state/players/static с заданной суммарной частотой.
+// Задержка считается от запланированного момента отправки, поэтому отставание клиента
+// от графика тоже попадает в перцентили.
+#define BOOST_BEAST_USE_STD_STRING_VIEW
+
+#include "sdk.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/json.hpp>
+#include <boost/program_options.hpp>
+
+using namespace std::literals;
+namespace net = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace json = boost::json;
+using tcp = net::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+enum RequestKind : size_t {
+    ACTION,
+    STATE,
+    PLAYERS,
+    STATIC,
+    KIND_COUNT
+};
+
+constexpr std::array<std::string_view, KIND_COUNT> KIND_NAMES = {"action"sv, "state"sv, "players"sv, "static"sv};
+
+struct Args {
+    std::string host = "127.0.0.1";
+    std::string port = "8080";
+    std::string map_id;
+    std::string static_target = "/index.html";
+    int connections = 16;
+    int players = 100;
+    double rate = 1000;
+    int seconds = 10;
+    int timeout_ms = 2000;
+    std::vector<std::string> mix;
+    std::array<double, KIND_COUNT> weights = {40, 40, 10, 10};
+};
+
+[[nodiscard]] std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
+    namespace po = boost::program_options;
+
+    po::options_description desc{"All options"s};
+    Args args;
+    desc.add_options()           //
+        ("help,h", "Show help")  //
+        ("host", po::value(&args.host)->value_name("address"s), "Set server address") //
+        ("port,p", po::value(&args.port)->value_name("port"s), "Set server port") //
+        ("map", po::value(&args.map_id)->value_name("id"s), "Join players to this map, the first map by default") //
+        ("static-target", po::value(&args.static_target)->value_name("uri"s), "Static file for static requests") //
+        ("connections,n", po::value(&args.connections)->value_name("count"s), "Set keep-alive connections count") //
+        ("players", po::value(&args.players)->value_name("count"s), "Set joined players count") //
+        ("rate,r", po::value(&args.rate)->value_name("requests/s"s), "Set total request rate") //
+        ("seconds,s", po::value(&args.seconds)->value_name("seconds"s), "Set load duration") //
+        ("timeout", po::value(&args.timeout_ms)->value_name("milliseconds"s), "Set connect and request timeout") //
+        ("mix", po::value(&args.mix)->multitoken()->value_name("kind=weight"s),
+            "Set request mix, e.g. action=40 state=40 players=10 static=10");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.contains("help"s)) {
+        std::cout << desc;
+        return std::nullopt;
+    }
+    if (args.connections < 1 || args.players < 1 || args.rate <= 0 || args.seconds < 1 || args.timeout_ms < 1) {
+        throw std::runtime_error("Counts, rate and duration must be positive"s);
+    }
+    if (!args.mix.empty()) {
+        args.weights.fill(0);
+        for (const auto& item : args.mix) {
+            const auto pos = item.find('=');
+            const auto it = std::find(KIND_NAMES.begin(), KIND_NAMES.end(), std::string_view(item).substr(0, pos));
+            if (pos == std::string::npos || it == KIND_NAMES.end()) {
+                throw std::runtime_error("Invalid mix item: "s + item);
+            }
+            args.weights[size_t(it - KIND_NAMES.begin())] = std::stod(item.substr(pos + 1));
+        }
+    }
+    return args;
+}
+
+/*
+ * Keep-alive соединение с синхронным интерфейсом.
+ * Таймауты tcp_stream действуют только на асинхронные операции, поэтому каждая операция
+ * запускается асинхронно и дожидается завершения в собственном io_context соединения.
+ */
+class Connection {
+public:
+    Connection(const tcp::resolver::results_type& endpoints, std::chrono::milliseconds timeout)
+        : stream_(ioc_)
+        , endpoints_(endpoints)
+        , timeout_(timeout) {
+        if (const auto ec = Connect()) {
+            throw beast::system_error(ec);
+        }
+    }
+
+    // при ошибке соединение переустанавливается, ec описывает неудавшийся запрос,
+    // beast::error::timeout - если запрос не уложился в таймаут
+    http::response<http::string_body> Send(http::request<http::string_body>& req, beast::error_code& ec) {
+        req.set(http::field::host, "localhost");
+        req.keep_alive(true);
+        req.prepare_payload();
+        http::response<http::string_body> res;
+        stream_.expires_after(timeout_);
+        http::async_write(stream_, req, [&](beast::error_code write_ec, size_t) {
+            ec = write_ec;
+            if (!ec) {
+                http::async_read(stream_, buffer_, res, [&](beast::error_code read_ec, size_t) {
+                    ec = read_ec;
+                });
+            }
+        });
+        Run();
+        if (ec || res.need_eof()) {
+            Reconnect();
+        }
+        return res;
+    }
+
+private:
+    beast::error_code Connect() {
+        beast::error_code ec;
+        stream_.expires_after(timeout_);
+        stream_.async_connect(endpoints_, [&ec](beast::error_code connect_ec, const tcp::endpoint&) {
+            ec = connect_ec;
+        });
+        Run();
+        return ec;
+    }
+
+    void Reconnect() {
+        beast::error_code ignored;
+        stream_.socket().close(ignored);
+        buffer_.clear();
+        Connect();
+    }
+
+    void Run() {
+        ioc_.restart();
+        ioc_.run();
+    }
+
+    net::io_context ioc_;
+    beast::tcp_stream stream_;
+    tcp::resolver::results_type endpoints_;
+    std::chrono::milliseconds timeout_;
+    beast::flat_buffer buffer_;
+};
+
+http::request<http::string_body> MakeRequest(http::verb method, std::string_view target, std::string body = {}) {
+    http::request<http::string_body> req{method, target, 11};
+    if (!body.empty()) {
+        req.set(http::field::content_type, "application/json");
+        req.body() = std::move(body);
+    }
+    return req;
+}
+
+std::string GetFirstMapId(Connection& connection) {
+    auto req = MakeRequest(http::verb::get, "/api/v1/maps"sv);
+    beast::error_code ec;
+    auto res = connection.Send(req, ec);
+    if (ec || res.result() != http::status::ok) {
+        throw std::runtime_error("Failed to list maps"s);
+    }
+    const auto maps = json::parse(res.body()).as_array();
+    if (maps.empty()) {
+        throw std::runtime_error("Server has no maps"s);
+    }
+    return maps.front().at("id").as_string().c_str();
+}
+
+std::vector<std::string> JoinPlayers(Connection& connection, const Args& args, const std::string& map_id) {
+    std::vector<std::string> tokens;
+    for (int i = 0; i < args.players; ++i) {
+        json::object body{{"userName", "load" + std::to_string(i)}, {"mapId", map_id}};
+        auto req = MakeRequest(http::verb::post, "/api/v1/game/join"sv, json::serialize(body));
+        beast::error_code ec;
+        auto res = connection.Send(req, ec);
+        if (ec || res.result() != http::status::ok) {
+            throw std::runtime_error("Failed to join player: "s + (ec ? ec.message() : res.body()));
+        }
+        tokens.push_back(json::parse(res.body()).at("authToken").as_string().c_str());
+    }
+    return tokens;
+}
+
+struct ClientStats {
+    std::array<std::vector<std::uint32_t>, KIND_COUNT> latencies_us;
+    std::array<std::uint64_t, KIND_COUNT> errors{};
+    // входят в errors
+    std::array<std::uint64_t, KIND_COUNT> timeouts{};
+    // клиенты, которые не смогли подключиться и не отправили ни одного запроса
+    std::uint64_t connect_errors = 0;
+};
+
+ClientStats RunClient(const tcp::resolver::results_type& endpoints, const Args& args,
+                      const std::vector<std::string>& tokens, unsigned seed,
+                      Clock::time_point start, Clock::time_point deadline) {
+    ClientStats stats;
+    // исключение из потока клиента завершило бы весь процесс
+    std::optional<Connection> connection;
+    try {
+        connection.emplace(endpoints, std::chrono::milliseconds(args.timeout_ms));
+    } catch (const beast::system_error&) {
+        ++stats.connect_errors;
+        return stats;
+    }
+    std::mt19937 random(seed);
+    std::discrete_distribution<size_t> kinds(args.weights.begin(), args.weights.end());
+    const auto interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(args.connections / args.rate));
+    constexpr std::array<std::string_view, 4> moves = {"L"sv, "R"sv, "U"sv, "D"sv};
+
+    // равномерный график, соединения сдвинуты друг относительно друга
+    auto scheduled = start + interval * (seed % args.connections) / args.connections;
+    for (; scheduled < deadline; scheduled += interval) {
+        std::this_thread::sleep_until(scheduled);
+        const size_t kind = kinds(random);
+        const auto& token = tokens[random() % tokens.size()];
+        http::request<http::string_body> req;
+        switch (kind) {
+            case ACTION:
+                req = MakeRequest(http::verb::post, "/api/v1/game/player/action"sv,
+                                  R"({"move":")"s + std::string(moves[random() % moves.size()]) + R"("})"s);
+                break;
+            case STATE:
+                req = MakeRequest(http::verb::get, "/api/v1/game/state"sv);
+                break;
+            case PLAYERS:
+                req = MakeRequest(http::verb::get, "/api/v1/game/players"sv);
+                break;
+            default:
+                req = MakeRequest(http::verb::get, args.static_target);
+        }
+        if (kind != STATIC) {
+            req.set(http::field::authorization, "Bearer " + token);
+        }
+        beast::error_code ec;
+        const auto res = connection->Send(req, ec);
+        if (ec || res.result_int() >= 400) {
+            ++stats.errors[kind];
+            if (ec == beast::error::timeout) {
+                ++stats.timeouts[kind];
+            }
+            continue;
+        }
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - scheduled);
+        stats.latencies_us[kind].push_back(std::uint32_t(latency.count()));
+    }
+    return stats;
+}
+
+void PrintLatencies(std::string_view name, std::vector<std::uint32_t>& latencies, std::uint64_t errors,
+                    std::uint64_t timeouts, std::chrono::duration<double> elapsed) {
+    std::cout << name << ": ok " << latencies.size() << ", errors " << errors << " (timeouts " << timeouts << ")"
+              << ", " << latencies.size() / elapsed.count() << " req/s";
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&latencies](double p) {
+            return latencies[std::min(latencies.size() - 1, size_t(p * latencies.size()))] / 1000.0;
+        };
+        std::cout << ", ms p50 " << percentile(0.5) << ", p90 " << percentile(0.9)
+                  << ", p99 " << percentile(0.99) << ", p99.9 " << percentile(0.999)
+                  << ", max " << latencies.back() / 1000.0;
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, const char* argv[]) {
+    try {
+        auto args = ParseCommandLine(argc, argv);
+        if (!args) {
+            return EXIT_SUCCESS;
+        }
+        net::io_context ioc;
+        tcp::resolver resolver(ioc);
+        const auto endpoints = resolver.resolve(args->host, args->port);
+
+        Connection connection(endpoints, std::chrono::milliseconds(args->timeout_ms));
+        const auto map_id = args->map_id.empty() ? GetFirstMapId(connection) : args->map_id;
+        const auto tokens = JoinPlayers(connection, *args, map_id);
+        std::cout << "joined " << tokens.size() << " players to map " << map_id << std::endl;
+
+        const auto start = Clock::now();
+        const auto deadline = start + std::chrono::seconds(args->seconds);
+        std::vector<ClientStats> stats(args->connections);
+        {
+            std::vector<std::jthread> clients;
+            for (int i = 0; i < args->connections; ++i) {
+                clients.emplace_back([&, i] {
+                    stats[i] = RunClient(endpoints, *args, tokens, unsigned(i), start, deadline);
+                });
+            }
+        }
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+        ClientStats total;
+        for (auto& client : stats) {
+            for (size_t kind = 0; kind < KIND_COUNT; ++kind) {
+                auto& latencies = total.latencies_us[kind];
+                latencies.insert(latencies.end(), client.latencies_us[kind].begin(), client.latencies_us[kind].end());
+                total.errors[kind] += client.errors[kind];
+                total.timeouts[kind] += client.timeouts[kind];
+            }
+            total.connect_errors += client.connect_errors;
+        }
+        std::vector<std::uint32_t> all;
+        std::uint64_t all_errors = 0;
+        std::uint64_t all_timeouts = 0;
+        for (size_t kind = 0; kind < KIND_COUNT; ++kind) {
+            all.insert(all.end(), total.latencies_us[kind].begin(), total.latencies_us[kind].end());
+            all_errors += total.errors[kind];
+            all_timeouts += total.timeouts[kind];
+            if (args->weights[kind] > 0) {
+                PrintLatencies(KIND_NAMES[kind], total.latencies_us[kind], total.errors[kind], total.timeouts[kind], elapsed);
+            }
+        }
+        PrintLatencies("total"sv, all, all_errors, all_timeouts, elapsed);
+        if (total.connect_errors > 0) {
+            std::cout << "connect errors: " << total.connect_errors << " of " << args->connections
+                      << " connections" << std::endl;
+        }
+        return EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,194 @@
+// Замер скорости симуляции без HTTP: собаки со случайными командами в нескольких сессиях,
+// игра обновляется UpdateGameStateUseCase::Update заданное число тиков.
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "json_loader.h"
+#include "use_cases.h"
+
+using namespace std::literals;
+
+namespace {
+
+// считаем только выделения внутри замеряемого участка
+std::atomic<bool> count_allocations = false;
+std::atomic<std::uint64_t> allocations = 0;
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    if (count_allocations.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+struct Args {
+    std::string config = "./data/config.json";
+    int dogs = 1000;
+    int sessions = 1;
+    int ticks = 10000;
+    int tick_ms = 50;
+    int turn_every = 20;
+    unsigned seed = 42;
+    bool fixed_point = false;
+};
+
+[[nodiscard]] std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
+    namespace po = boost::program_options;
+
+    po::options_description desc{"All options"s};
+    Args args;
+    desc.add_options()           //
+        ("help,h", "Show help")  //
+        ("config-file,c", po::value(&args.config)->value_name("file"s), "Set config file path") //
+        ("dogs,n", po::value(&args.dogs)->value_name("count"s), "Set total dogs count") //
+        ("sessions,m", po::value(&args.sessions)->value_name("count"s), "Set game sessions count") //
+        ("ticks,k", po::value(&args.ticks)->value_name("count"s), "Set simulated ticks count") //
+        ("tick-period,t", po::value(&args.tick_ms)->value_name("milliseconds"s), "Set simulated tick period") //
+        ("turn-every", po::value(&args.turn_every)->value_name("ticks"s), "Change dog directions every N ticks") //
+        ("seed", po::value(&args.seed)->value_name("number"s), "Set random seed") //
+        ("fixed-point", po::bool_switch(&args.fixed_point), "Keep coordinates on the fixed-point grid");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.contains("help"s)) {
+        std::cout << desc;
+        return std::nullopt;
+    }
+    if (args.dogs < 0 || args.sessions < 1 || args.ticks < 1 || args.tick_ms < 1 || args.turn_every < 1) {
+        throw std::runtime_error("Counts and periods must be positive"s);
+    }
+    return args;
+}
+
+void CreateSessions(model::Game& game, const Args& args, std::mt19937& random) {
+    auto& sessions = game.GetSessions();
+    // сессия на каждую карту, дальше карты повторяются
+    for (const auto& map : game.GetMaps()) {
+        if (int(sessions.size()) == args.sessions) {
+            break;
+        }
+        game.FindSession(map.GetId());
+    }
+    for (auto it = sessions.begin(); int(sessions.size()) < args.sessions; ++it) {
+        game.AddSession(it->GetMapId());
+    }
+
+    std::vector<model::GameSession*> session_list;
+    for (auto& session : sessions) {
+        session_list.push_back(&session);
+    }
+    // точка по длине всех дорог карты ищется за O(log R)
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    for (int i = 0; i < args.dogs; ++i) {
+        auto& session = *session_list[i % session_list.size()];
+        const auto point = session.GetMap().GetPointOnRoads(dist(random), dist(random));
+        auto& dog = *session.FindDog(session.AddPlayer("dog"s + std::to_string(i)));
+        dog.SetPosition(point.x, point.y);
+    }
+}
+
+void TurnDogs(model::Game& game, std::mt19937& random) {
+    for (auto& session : game.GetSessions()) {
+        const double speed = session.GetMap().GetDogSpeed();
+        for (auto& dog : session.GetDogs()) {
+            switch (random() % 5) {
+                case 0: dog.SetSpeed(-speed, 0.0); dog.SetDirection(model::Direction::LEFT); break;
+                case 1: dog.SetSpeed(speed, 0.0); dog.SetDirection(model::Direction::RIGHT); break;
+                case 2: dog.SetSpeed(0.0, -speed); dog.SetDirection(model::Direction::UP); break;
+                case 3: dog.SetSpeed(0.0, speed); dog.SetDirection(model::Direction::DOWN); break;
+                default: dog.SetSpeed(0.0, 0.0); break;
+            }
+        }
+    }
+}
+
+int main(int argc, const char* argv[]) {
+    try {
+        auto args = ParseCommandLine(argc, argv);
+        if (!args) {
+            return EXIT_SUCCESS;
+        }
+        auto game = json_loader::LoadGame(args->config);
+        if (game.GetMaps().empty()) {
+            throw std::runtime_error("Config has no maps"s);
+        }
+        std::mt19937 random(args->seed);
+        if (args->fixed_point) {
+            game.SetFixedPointCoordinates(true);
+        }
+        CreateSessions(game, *args, random);
+        app::UpdateGameStateUseCase update_game(game);
+        const std::chrono::milliseconds tick(args->tick_ms);
+
+        std::chrono::steady_clock::duration elapsed{};
+        std::uint64_t tick_allocations = 0;
+        for (int i = 0; i < args->ticks; ++i) {
+            if (i % args->turn_every == 0) {
+                TurnDogs(game, random);
+            }
+            allocations.store(0, std::memory_order_relaxed);
+            count_allocations.store(true, std::memory_order_relaxed);
+            const auto start = std::chrono::steady_clock::now();
+            update_game.Update(tick);
+            elapsed += std::chrono::steady_clock::now() - start;
+            count_allocations.store(false, std::memory_order_relaxed);
+            // игроков в замере нет, достаточно забыть ушедших собак
+            update_game.TakeRetiredDogs();
+            tick_allocations += allocations.load(std::memory_order_relaxed);
+        }
+
+        size_t loot = 0;
+        for (auto& session : game.GetSessions()) {
+            loot += session.GetLoot().size();
+        }
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        const double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+        std::cout << "sessions: " << game.GetSessions().size() << ", dogs: " << args->dogs
+                  << ", ticks: " << args->ticks << ", loot: " << loot << std::endl;
+        std::cout << "ticks/s: " << args->ticks / seconds << std::endl;
+        std::cout << "ns/tick: " << ns / args->ticks << std::endl;
+        if (args->dogs > 0) {
+            std::cout << "ns/dog/tick: " << ns / args->ticks / args->dogs << std::endl;
+        }
+        std::cout << "allocations/tick: " << double(tick_allocations) / args->ticks << std::endl;
+        return EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
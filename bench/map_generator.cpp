@@ -0,0 +1,259 @@
+// Генератор конфигураций с большими картами для нагрузочных замеров.
+// Дороги не перекрываются на одной линии (перекрывающиеся дороги модель считает одной),
+// здания стоят внутри кварталов, офисы - на дорогах.
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <boost/json.hpp>
+#include <boost/program_options.hpp>
+
+using namespace std::literals;
+namespace json = boost::json;
+
+struct Args {
+    std::string layout = "grid";
+    std::string output;
+    int maps = 1;
+    int roads = 1000;
+    int buildings = 100;
+    int offices = 10;
+    int loot_types = 4;
+    int block = 20;
+    double dog_speed = 4.0;
+    unsigned seed = 42;
+};
+
+[[nodiscard]] std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
+    namespace po = boost::program_options;
+
+    po::options_description desc{"All options"s};
+    Args args;
+    desc.add_options()           //
+        ("help,h", "Show help")  //
+        ("layout,l", po::value(&args.layout)->value_name("grid|random|city"s), "Set road network layout") //
+        ("output,o", po::value(&args.output)->value_name("file"s), "Write config to file instead of stdout") //
+        ("maps", po::value(&args.maps)->value_name("count"s), "Set maps count") //
+        ("roads,r", po::value(&args.roads)->value_name("count"s), "Set roads count per map") //
+        ("buildings,b", po::value(&args.buildings)->value_name("count"s), "Set buildings count per map") //
+        ("offices", po::value(&args.offices)->value_name("count"s), "Set offices count per map") //
+        ("loot-types", po::value(&args.loot_types)->value_name("count"s), "Set loot types count per map") //
+        ("block", po::value(&args.block)->value_name("length"s), "Set distance between parallel streets") //
+        ("dog-speed", po::value(&args.dog_speed)->value_name("speed"s), "Set dog speed") //
+        ("seed", po::value(&args.seed)->value_name("number"s), "Set random seed");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.contains("help"s)) {
+        std::cout << desc;
+        return std::nullopt;
+    }
+    if (args.layout != "grid"sv && args.layout != "random"sv && args.layout != "city"sv) {
+        throw std::runtime_error("Unknown layout: "s + args.layout);
+    }
+    if (args.maps < 1 || args.roads < 1 || args.block < 4 || args.loot_types < 1
+        || args.buildings < 0 || args.offices < 0) {
+        throw std::runtime_error("Invalid map parameters"s);
+    }
+    return args;
+}
+
+struct Road {
+    int x0, y0;
+    int x1, y1;
+};
+
+class MapGenerator {
+public:
+    MapGenerator(const Args& args, std::mt19937& random)
+        : args_(args)
+        , random_(random) {
+    }
+
+    json::object Generate(int index) {
+        roads_.clear();
+        if (args_.layout == "random"sv) {
+            MakeRandomRoads();
+        } else {
+            MakeGridRoads(args_.layout == "city"sv);
+        }
+        if (int(roads_.size()) < args_.roads) {
+            throw std::runtime_error("Only "s + std::to_string(roads_.size()) + " of "s + std::to_string(args_.roads)
+                                     + " roads fit into map "s + std::to_string(index + 1));
+        }
+
+        json::object map;
+        map["id"] = "map" + std::to_string(index + 1);
+        map["name"] = "Generated " + args_.layout + " map " + std::to_string(index + 1);
+        map["dogSpeed"] = args_.dog_speed;
+        map["lootTypes"] = MakeLootTypes();
+        map["roads"] = SerializeRoads();
+        map["buildings"] = MakeBuildings();
+        map["offices"] = MakeOffices();
+        return map;
+    }
+
+private:
+    int Random(int min, int max) {
+        return std::uniform_int_distribution<int>(min, max)(random_);
+    }
+
+    // Сетка side x side перекрёстков, каждый отрезок между соседними перекрёстками - отдельная дорога.
+    // В городском варианте часть переулков пропускается, а каждая пятая улица остаётся сквозной.
+    void MakeGridRoads(bool is_city) {
+        int side = 2;
+        while (2 * side * (side - 1) < args_.roads * (is_city ? 2 : 1)) {
+            ++side;
+        }
+        side_ = side;
+        for (int line = 0; line < side && int(roads_.size()) < args_.roads; ++line) {
+            const bool is_avenue = line % 5 == 0;
+            for (int i = 0; i + 1 < side && int(roads_.size()) < args_.roads; ++i) {
+                if (is_city && !is_avenue && Random(0, 1) == 0) {
+                    continue;
+                }
+                roads_.push_back({i * args_.block, line * args_.block, (i + 1) * args_.block, line * args_.block});
+                if (int(roads_.size()) < args_.roads) {
+                    roads_.push_back({line * args_.block, i * args_.block, line * args_.block, (i + 1) * args_.block});
+                }
+            }
+        }
+    }
+
+    // Случайные отрезки вдоль линий сетки, на каждой линии идут подряд с промежутками.
+    // Если все линии заполнились раньше, чем набралось нужное число дорог, карта строится заново с большим числом линий
+    void MakeRandomRoads() {
+        for (int lines = std::max(2, int(std::sqrt(double(args_.roads)))); !TryMakeRandomRoads(lines); ++lines) {
+            roads_.clear();
+        }
+    }
+
+    bool TryMakeRandomRoads(int lines) {
+        side_ = lines;
+        const int length = lines * args_.block;
+        std::vector<int> cursors(2 * lines, 0);
+        while (int(roads_.size()) < args_.roads) {
+            const int line = Random(0, 2 * lines - 1);
+            int& cursor = cursors[line];
+            if (cursor >= length) {
+                // линия заполнена, продолжаем на другой
+                if (std::all_of(cursors.begin(), cursors.end(), [length](int c) { return c >= length; })) {
+                    return false;
+                }
+                continue;
+            }
+            const int start = cursor + Random(0, args_.block);
+            const int end = std::min(length + args_.block, start + Random(1, 3 * args_.block));
+            cursor = end + 1;
+            const int coord = (line % lines) * args_.block;
+            if (line < lines) {
+                roads_.push_back({start, coord, end, coord});
+            } else {
+                roads_.push_back({coord, start, coord, end});
+            }
+        }
+        return true;
+    }
+
+    json::array SerializeRoads() const {
+        json::array result;
+        result.reserve(roads_.size());
+        for (const auto& road : roads_) {
+            if (road.y0 == road.y1) {
+                result.push_back(json::object{{"x0", road.x0}, {"y0", road.y0}, {"x1", road.x1}});
+            } else {
+                result.push_back(json::object{{"x0", road.x0}, {"y0", road.y0}, {"y1", road.y1}});
+            }
+        }
+        return result;
+    }
+
+    // Здания занимают середину квартала, не задевая дороги
+    json::array MakeBuildings() {
+        json::array result;
+        const int blocks = std::max(1, side_ - 1);
+        const int margin = 2;
+        for (int i = 0; i < args_.buildings; ++i) {
+            const int bx = Random(0, blocks - 1);
+            const int by = Random(0, blocks - 1);
+            const int w = Random(1, args_.block - 2 * margin);
+            const int h = Random(1, args_.block - 2 * margin);
+            result.push_back(json::object{
+                {"x", bx * args_.block + margin}, {"y", by * args_.block + margin}, {"w", w}, {"h", h}});
+        }
+        return result;
+    }
+
+    json::array MakeOffices() {
+        json::array result;
+        for (int i = 0; i < args_.offices; ++i) {
+            const auto& road = roads_[Random(0, int(roads_.size()) - 1)];
+            result.push_back(json::object{
+                {"id", "o" + std::to_string(i)}, {"x", road.x0}, {"y", road.y0}, {"offsetX", 5}, {"offsetY", 0}});
+        }
+        return result;
+    }
+
+    json::array MakeLootTypes() {
+        // модели из static/assets
+        constexpr std::array<std::string_view, 2> models = {"key"sv, "wallet"sv};
+        json::array result;
+        for (int i = 0; i < args_.loot_types; ++i) {
+            const auto model = models[i % models.size()];
+            result.push_back(json::object{
+                {"name", std::string(model) + std::to_string(i)},
+                {"file", "assets/" + std::string(model) + ".obj"},
+                {"type", "obj"},
+                {"rotation", Random(0, 3) * 90},
+                {"color", i % 2 ? "#883344" : "#338844"},
+                {"scale", model == "key"sv ? 0.03 : 0.01},
+                {"value", Random(1, 10) * 10}});
+        }
+        return result;
+    }
+
+    const Args& args_;
+    std::mt19937& random_;
+    std::vector<Road> roads_;
+    int side_ = 0;
+};
+
+int main(int argc, const char* argv[]) {
+    try {
+        auto args = ParseCommandLine(argc, argv);
+        if (!args) {
+            return EXIT_SUCCESS;
+        }
+        std::mt19937 random(args->seed);
+        MapGenerator generator(*args, random);
+        json::array maps;
+        for (int i = 0; i < args->maps; ++i) {
+            maps.push_back(generator.Generate(i));
+        }
+        json::object config{
+            {"defaultDogSpeed", args->dog_speed},
+            {"lootGeneratorConfig", {{"period", 5.0}, {"probability", 0.5}}},
+            {"maps", std::move(maps)}};
+
+        if (args->output.empty()) {
+            std::cout << json::serialize(config) << std::endl;
+        } else {
+            std::ofstream output(args->output);
+            if (!output) {
+                throw std::runtime_error("Failed to open "s + args->output);
+            }
+            output << json::serialize(config) << std::endl;
+        }
+        return EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,147 @@
+// Нагрузочный замер раздачи статики: сервер работает в одном потоке (одно ядро),
+// клиенты в отдельных потоках гоняют GET-запросы по keep-alive соединениям.
+#include "sdk.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "http_server.h"
+#include "static_cache.h"
+
+using namespace std::literals;
+namespace net = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+using tcp = net::ip::tcp;
+
+struct Args {
+    std::string static_dir = "./static";
+    unsigned short port = 8081;
+    int seconds = 5;
+    int connections = 4;
+    bool gzip = false;
+    std::vector<std::string> targets;
+};
+
+[[nodiscard]] std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
+    namespace po = boost::program_options;
+
+    po::options_description desc{"All options"s};
+    Args args;
+    desc.add_options()           //
+        ("help,h", "Show help")  //
+        ("www-root,w", po::value(&args.static_dir)->value_name("dir"s), "Set static files root")  //
+        ("port,p", po::value(&args.port)->value_name("port"s), "Set server port") //
+        ("seconds,s", po::value(&args.seconds)->value_name("seconds"s), "Set benchmark duration") //
+        ("connections,n", po::value(&args.connections)->value_name("count"s), "Set client connections count") //
+        ("gzip,z", po::bool_switch(&args.gzip), "Request gzip encoded files") //
+        ("target", po::value(&args.targets)->multitoken()->value_name("uri"s), "Requested files");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.contains("help"s)) {
+        std::cout << desc;
+        return std::nullopt;
+    }
+    if (args.targets.empty()) {
+        args.targets = {"/index.html"s, "/js/game.js"s, "/favicon.ico"s, "/js/three.js"s, "/assets/pug.fbx"s};
+    }
+    return args;
+}
+
+struct ClientStats {
+    std::uint64_t requests = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t errors = 0;
+};
+
+ClientStats RunClient(const tcp::endpoint& endpoint, const Args& args,
+                      std::chrono::steady_clock::time_point deadline) {
+    const auto& targets = args.targets;
+    ClientStats stats;
+    net::io_context ioc;
+    beast::tcp_stream stream(ioc);
+    stream.connect(endpoint);
+    beast::flat_buffer buffer;
+    for (size_t i = 0; std::chrono::steady_clock::now() < deadline; ++i) {
+        http::request<http::empty_body> req{http::verb::get, targets[i % targets.size()], 11};
+        req.set(http::field::host, "localhost");
+        req.keep_alive(true);
+        if (args.gzip) {
+            req.set(http::field::accept_encoding, "gzip");
+        }
+        http::response_parser<http::string_body> parser;
+        parser.body_limit(std::numeric_limits<std::uint64_t>::max());
+        beast::error_code ec;
+        http::write(stream, req, ec);
+        if (!ec) {
+            http::read(stream, buffer, parser, ec);
+        }
+        if (ec || parser.get().result() != http::status::ok) {
+            ++stats.errors;
+            if (ec) {
+                break;
+            }
+            continue;
+        }
+        ++stats.requests;
+        stats.bytes += parser.get().body().size();
+    }
+    return stats;
+}
+
+int main(int argc, const char* argv[]) {
+    try {
+        auto args = ParseCommandLine(argc, argv);
+        if (!args) {
+            return EXIT_SUCCESS;
+        }
+        http_handler::StaticFileCache static_files(args->static_dir);
+        std::cout << "cached files: " << static_files.GetFilesCount() << std::endl;
+
+        net::io_context server_ioc(1);
+        const tcp::endpoint endpoint(net::ip::make_address("127.0.0.1"), args->port);
+        http_server::ServeHttp(server_ioc, endpoint, [&static_files](tcp::endpoint&, auto&& req, auto&& send) {
+            static_files.Serve(req, std::forward<decltype(send)>(send));
+        });
+        std::thread server([&server_ioc] {
+            server_ioc.run();
+        });
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto deadline = start + std::chrono::seconds(args->seconds);
+        std::vector<ClientStats> stats(args->connections);
+        {
+            std::vector<std::jthread> clients;
+            for (int i = 0; i < args->connections; ++i) {
+                clients.emplace_back([&, i] {
+                    stats[i] = RunClient(endpoint, *args, deadline);
+                });
+            }
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        server_ioc.stop();
+        server.join();
+
+        ClientStats total;
+        for (const auto& s : stats) {
+            total.requests += s.requests;
+            total.bytes += s.bytes;
+            total.errors += s.errors;
+        }
+        std::cout << "requests: " << total.requests << ", errors: " << total.errors << std::endl;
+        std::cout << "requests/s: " << total.requests / elapsed.count() << std::endl;
+        std::cout << "MiB/s: " << total.bytes / elapsed.count() / (1024 * 1024) << std::endl;
+        return EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
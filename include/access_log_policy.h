@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace server_logging {
+
+enum class LogLevel {
+    TRACE,
+    DEBUG,
+    INFO,
+    WARNING,
+    ERROR
+};
+
+/*
+ *  Политика журнала доступа.
+ *  Решает до форматирования записи, нужно ли её писать:
+ *  - обычные запросы пишутся с уровнем info и могут прореживаться по маршрутам;
+ *  - ответы 4xx пишутся с уровнем warning без прореживания;
+ *  - ответы 5xx и медленные ответы пишутся всегда.
+ */
+class AccessLogPolicy {
+public:
+    using Clock = std::chrono::system_clock;
+
+    // маршрут, обозначающий все запросы к статике (всё, что не начинается с /api/)
+    constexpr static std::string_view STATIC_ROUTE = "static";
+    constexpr static std::chrono::milliseconds DEFAULT_SLOW_THRESHOLD{500};
+
+    struct SampleRate {
+        std::string route;  // префикс URI или STATIC_ROUTE
+        double rate;        // доля записываемых запросов от 0 до 1
+    };
+
+    AccessLogPolicy() = default;
+    AccessLogPolicy(LogLevel min_level, std::vector<SampleRate> sample_rates,
+                    std::chrono::milliseconds slow_threshold = DEFAULT_SLOW_THRESHOLD);
+
+    // вызывается при получении запроса: пишется ли строка "request received"
+    bool ShouldLogRequest(std::string_view target) const;
+
+    // вызывается при отправке ответа; sampled - результат ShouldLogRequest для этого запроса
+    bool ShouldLogResponse(bool sampled, unsigned code, Clock::duration duration) const {
+        if (code >= 500 || duration >= slow_threshold_) {
+            return true;
+        }
+        if (code >= 400) {
+            return min_level_ <= LogLevel::WARNING;
+        }
+        return sampled;
+    }
+
+    // "info", "warning", ... -> LogLevel, бросает std::invalid_argument при неизвестном уровне
+    static LogLevel ParseLevel(std::string_view level);
+    // "route=rate" -> SampleRate, бросает std::invalid_argument при ошибке формата
+    static SampleRate ParseSampleRate(std::string_view sample_rate);
+
+private:
+    double FindRate(std::string_view target) const;
+
+    LogLevel min_level_ = LogLevel::INFO;
+    std::vector<SampleRate> sample_rates_;
+    std::chrono::milliseconds slow_threshold_ = DEFAULT_SLOW_THRESHOLD;
+};
+
+}  // namespace server_logging
@@ -27,6 +27,7 @@ using Application = app::Application;
 struct ContentType {
     ContentType() = delete;
     constexpr static std::string_view APP_JSON = "application/json"sv;
+    constexpr static std::string_view APP_OCTET_STREAM = "application/octet-stream"sv;
 };
 
 struct ErrorStatus {
@@ -55,12 +56,15 @@ private:
         return StringResponse();
     }
     StringResponse AddPlayer(std::string_view body);
-    StringResponse GetPlayers(const Token& token, std::string_view body);
-    StringResponse GetGameState(const Token& token, std::string_view body);
+    StringResponse GetPlayers(const Token& token, const StringRequest& request);
+    StringResponse GetGameState(const Token& token, const StringRequest& request);
     StringResponse UpdateGameState(std::string_view body);
     StringResponse SetPlayerAction(const Token& token, std::string_view body);
     StringResponse HandleMapsRequest(const StringRequest& request);
     bool ValidatePlayerMove(const std::string_view& move);
+    // двоичный ответ отдаётся, только если клиент явно его принимает, остальным - прежний JSON
+    app::ResponseEncoding GetResponseEncoding(const StringRequest& request) const;
+    void SetStateHeaders(StringResponse& response, app::ResponseEncoding encoding) const;
 
     std::vector<std::string> GetParsedTarget(std::string_view target) const;
 
@@ -6,6 +6,7 @@
 #include "json_loader.h"
 #include "use_cases.h"
 #include "ticker.h"
+#include "metrics.h"
 
 
 namespace app{
@@ -29,16 +30,22 @@ public:
     
     Application(const std::filesystem::path& json_path, int tick_delta, bool is_position_random, Strand strand);
     Strand& GetApiStrand();
-    ListMapsUseCase::Maps ListMaps();
+    const ListMapsUseCase::Maps& ListMaps();
     const Map* FindMap(MapId id);
     JoinGameResult JoinGame(std::string map_id, std::string name);
     Player* FindPlayer(Token token);
-    std::string GetMapInfo(const Map& map);
-    std::string GetMapsSpec();
-    std::string ListPlayers(const Player& player);
-    std::string GetGameState(const Token& token);
+    // ответы пишутся сразу в тело ответа, без промежуточного DOM
+    void GetMapInfo(const Map& map, std::string& out);
+    void GetMapsSpec(std::string& out);
+    void ListPlayers(const Player& player, std::string& out, ResponseEncoding encoding = ResponseEncoding::JSON);
+    void GetGameState(const Token& token, std::string& out, ResponseEncoding encoding = ResponseEncoding::JSON);
     std::string MovePlayer(const Token& token,const std::string& move);
     void UpdateGame(const std::chrono::milliseconds& delta);
+    void AdvanceGame(std::chrono::milliseconds delta, std::chrono::milliseconds max_step);
+    // метрики в формате Prometheus, вызывается на api strand
+    std::string GetMetrics();
+    // замеры фаз последних тиков в формате Chrome trace_event
+    std::string GetTickTrace();
     bool IsTickRequestAllowed() {
         return is_tick_request_allowed_;
     }
@@ -47,10 +54,11 @@ public:
 
 private:
     json::array ParseRoads(const model::Roads& roads) const;
-    json::array ParseRoads(const std::vector<Road>& roads) const; // TODO delete after tests
-    json::array ParseBuildings(const std::vector<Building>& buildings) const;
-    json::array ParseOffices(const std::vector<Office>& offices) const;
-    json::array GetLootTypes(model::Map::LootTypes loot_types);
+    void WriteRoads(json_writer::JsonWriter& writer, const std::vector<Road>& roads) const; // TODO delete after tests
+    void WriteBuildings(json_writer::JsonWriter& writer, const std::vector<Building>& buildings) const;
+    void WriteOffices(json_writer::JsonWriter& writer, const std::vector<Office>& offices) const;
+    void WriteLootTypes(json_writer::JsonWriter& writer, const model::Map::LootTypes& loot_types) const;
+    std::string MakeSessionLabels(model::GameSession& session) const;
 
     Strand strand_;
 
@@ -61,6 +69,8 @@ private:
     std::shared_ptr<Ticker> ticker_;
     bool is_tick_request_allowed_ = true;
     bool is_game_started_ = false;
+    // размер прошлого состояния игры, чтобы сразу выделить под ответ достаточно памяти
+    size_t game_state_size_hint_ = 0;
 
     // use_cases
     ListMapsUseCase list_maps_use_case_;
@@ -70,6 +80,7 @@ private:
     GameStateUseCase game_state_use_case_;
     SetPlayerActionUseCase set_player_action_use_case_;
     UpdateGameStateUseCase update_game_use_case_;
+    RetirePlayersUseCase retire_players_use_case_;
 };
 
 } // namespace app
\ No newline at end of file
@@ -0,0 +1,132 @@
+#pragma once
+
+#define BOOST_BEAST_USE_STD_STRING_VIEW
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/ip/address.hpp>
+#include <boost/beast/http/verb.hpp>
+
+namespace server_logging {
+
+namespace net = boost::asio;
+namespace http = boost::beast::http;
+
+/*
+ *  Запись журнала фиксированного размера. На горячем пути только копируется в кольцевой буфер,
+ *  форматирование в JSON выполняет фоновый поток.
+ */
+struct LogRecord {
+    enum class Type : std::uint8_t {
+        REQUEST,
+        RESPONSE,
+        CONNECTION_CLOSED
+    };
+
+    // длинные URI и content-type обрезаются
+    constexpr static size_t MAX_TEXT_SIZE = 192;
+
+    Type type;
+    bool is_v4 = true;
+    http::verb method = http::verb::unknown;
+    std::uint16_t text_size = 0;
+    unsigned code = 0;
+    std::int64_t timestamp_us = 0;
+    std::int64_t duration_ns = 0;
+    net::ip::address_v6::bytes_type address{};
+    std::array<char, MAX_TEXT_SIZE> text;
+
+    void SetAddress(const net::ip::address& address);
+    void SetText(std::string_view text);
+};
+
+/*
+ *  Асинхронный журнал.
+ *  Каждый поток пишет в собственный кольцевой буфер без блокировок, фоновый поток
+ *  собирает записи из всех буферов, форматирует и пишет их в поток вывода пачками.
+ *  Если фоновый поток не успевает, новые записи отбрасываются (потери ограничены размером буфера),
+ *  а число отброшенных записей периодически выводится отдельной строкой.
+ */
+class AsyncLogger {
+public:
+    constexpr static size_t RING_CAPACITY = 1024; // степень двойки
+    constexpr static std::chrono::milliseconds FLUSH_PERIOD{5};
+
+    static AsyncLogger& Instance();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+    ~AsyncLogger();
+
+    void Start(std::ostream& output);
+    // дописывает все накопленные записи и останавливает фоновый поток
+    void Stop();
+
+    bool IsRunning() const noexcept {
+        return running_.load(std::memory_order_relaxed);
+    }
+
+    void LogRequest(const net::ip::address& address, std::string_view uri, http::verb method);
+    void LogResponse(const net::ip::address& address, std::chrono::nanoseconds duration, unsigned code,
+                     std::string_view content_type);
+    void LogConnectionClosed();
+
+    std::uint64_t GetDroppedCount() const noexcept {
+        return dropped_total_.load(std::memory_order_relaxed);
+    }
+
+private:
+    class Ring {
+    public:
+        bool TryPush(const LogRecord& record) noexcept;
+        // возвращает false, если буфер пуст
+        bool TryPop(LogRecord& record) noexcept;
+
+        std::uint64_t TakeDropped() noexcept {
+            return dropped_.exchange(0, std::memory_order_relaxed);
+        }
+
+    private:
+        constexpr static size_t MASK = RING_CAPACITY - 1;
+        static_assert((RING_CAPACITY & MASK) == 0, "Ring capacity must be a power of two");
+
+        std::array<LogRecord, RING_CAPACITY> records_;
+        alignas(64) std::atomic<std::uint64_t> head_ = 0;
+        alignas(64) std::atomic<std::uint64_t> tail_ = 0;
+        alignas(64) std::atomic<std::uint64_t> dropped_ = 0;
+    };
+
+    AsyncLogger() = default;
+
+    void Push(LogRecord& record);
+    Ring& GetThreadRing();
+    void Run();
+    // возвращает количество перенесённых в пачку записей
+    size_t Drain(std::string& batch);
+    void Format(const LogRecord& record, std::string& out);
+    void FormatTimestamp(std::int64_t timestamp_us, std::string& out);
+
+    std::atomic<bool> running_ = false;
+    std::ostream* output_ = nullptr;
+    std::thread worker_;
+
+    std::mutex rings_mutex_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+    std::atomic<std::uint64_t> dropped_total_ = 0;
+
+    // кэш отформатированной даты, обновляется раз в секунду
+    std::int64_t cached_second_ = -1;
+    std::string cached_date_;
+};
+
+}  // namespace server_logging
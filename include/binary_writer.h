@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace binary_writer {
+
+/*
+ * Запись чисел фиксированной ширины в little-endian в конец строки.
+ * Порядок байт задаётся сдвигами, поэтому не зависит от платформы сервера.
+ */
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::string& out) noexcept
+        : out_(out) {
+    }
+
+    BinaryWriter& U8(std::uint8_t value) {
+        out_ += char(value);
+        return *this;
+    }
+
+    BinaryWriter& U16(std::uint16_t value) {
+        return U8(std::uint8_t(value)).U8(std::uint8_t(value >> 8));
+    }
+
+    BinaryWriter& U32(std::uint32_t value) {
+        return U16(std::uint16_t(value)).U16(std::uint16_t(value >> 16));
+    }
+
+    BinaryWriter& I32(std::int32_t value) {
+        return U32(std::uint32_t(value));
+    }
+
+    // число с фиксированной точкой: value * scale, округлённое и ограниченное диапазоном int32
+    BinaryWriter& Fixed(double value, double scale) {
+        constexpr double MIN = std::numeric_limits<std::int32_t>::min();
+        constexpr double MAX = std::numeric_limits<std::int32_t>::max();
+        const double scaled = std::isfinite(value) ? std::clamp(std::round(value * scale), MIN, MAX) : 0.0;
+        return I32(std::int32_t(scaled));
+    }
+
+    // строка с длиной u16 впереди, длиннее 65535 байт обрезается
+    BinaryWriter& String(std::string_view value) {
+        const auto size = std::min<size_t>(value.size(), std::numeric_limits<std::uint16_t>::max());
+        U16(std::uint16_t(size));
+        out_.append(value.data(), size);
+        return *this;
+    }
+
+private:
+    std::string& out_;
+};
+
+}  // namespace binary_writer
@@ -57,4 +57,7 @@ struct GatheringEvent {
 // При проверке ваших тестов она не нужна - функция будет линковаться снаружи.
 std::vector<GatheringEvent> FindGatherEvents(const ItemGathererProvider& provider);
 
+// то же, но события пишутся в переданный вектор, чтобы переиспользовать его память между вызовами
+void FindGatherEvents(const ItemGathererProvider& provider, std::vector<GatheringEvent>& gathering_events);
+
 }  // namespace collision_detector
\ No newline at end of file
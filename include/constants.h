@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <unordered_set>
 
@@ -9,10 +10,25 @@ using namespace std::literals;
 namespace constants {
 
 const double ROAD_WIDTH = 0.4;
+// ширина собаки и офиса при сборе предметов, сами предметы - точки
+const double DOG_WIDTH = 0.6;
+const double OFFICE_WIDTH = 0.5;
 const double DEFAULT_DOG_SPEED = 1.0;
 const int DEFAULT_BAG_CAPACITY = 3;
 const int DEFAULT_LOOT_GENERATE_PERIOD = 5000;
 const double DEFAULT_LOOT_GENERATE_PROBABILITY = 0.5;
+// максимальный шаг симуляции при ручном тике, мс
+const int DEFAULT_MAX_TICK_STEP = 100;
+// больше шагов за один ручной тик не делаем, а удлиняем шаг: тик выполняется синхронно на api strand
+const int64_t MAX_TICK_SUBSTEPS = 10000;
+// 0 - количество игроков в сессии не ограничено
+const int DEFAULT_MAX_PLAYERS_PER_SESSION = 0;
+// сколько собака может простоять без движения, прежде чем игрок будет удалён, мс; 0 - не удалять
+const int DEFAULT_DOG_RETIREMENT_TIME = 0;
+// сколько собак удаляется за один тик, остальные ждут следующих тиков
+const int MAX_RETIREMENTS_PER_TICK = 64;
+// хранить ли координаты на сетке с фиксированной точкой, см. util::Fixed
+const bool DEFAULT_FIXED_POINT_COORDINATES = false;
 
 
 struct LootType
@@ -81,6 +97,8 @@ struct Endpoint {
     static inline constexpr std::string_view GAME_STATE = "/api/v1/game/state"sv;
     static inline constexpr std::string_view GAME_TICK = "/api/v1/game/tick"sv;
     static inline constexpr std::string_view PLAYER_ACTION = "/api/v1/game/player/action"sv;
+    static inline constexpr std::string_view METRICS = "/metrics"sv;
+    static inline constexpr std::string_view TICK_TRACE = "/admin/tick-trace"sv;
 };
 
 
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <limits>
+
+namespace util {
+
+/*
+ * Число с фиксированной точкой: int32 в единицах 1/1024.
+ * Это меньше тысячной доли ширины дороги, а диапазон остаётся ±2 млн клеток.
+ */
+class Fixed {
+public:
+    constexpr static int FRACTION_BITS = 10;
+    constexpr static std::int32_t SCALE = 1 << FRACTION_BITS;
+
+    constexpr Fixed() = default;
+
+    constexpr static Fixed FromRaw(std::int32_t raw) noexcept {
+        Fixed result;
+        result.raw_ = raw;
+        return result;
+    }
+
+    // ближайшее представимое число, за пределами диапазона - его граница, NaN - ноль
+    static Fixed FromDouble(double value) noexcept {
+        constexpr double MIN = std::numeric_limits<std::int32_t>::min();
+        constexpr double MAX = std::numeric_limits<std::int32_t>::max();
+        if (std::isnan(value)) {
+            return {};
+        }
+        return FromRaw(std::int32_t(std::clamp(std::round(value * SCALE), MIN, MAX)));
+    }
+
+    // округление до сетки 1/1024 без смены типа
+    static double Quantize(double value) noexcept {
+        return FromDouble(value).ToDouble();
+    }
+
+    // ближайшая к value точка сетки внутри [min, max], сами границы могут на сетке не лежать.
+    // Отрезок должен быть не короче шага сетки
+    static double Quantize(double value, double min, double max) noexcept {
+        const double result = Quantize(value);
+        if (result > max) {
+            return Quantize(std::floor(max * SCALE) / SCALE);
+        }
+        if (result < min) {
+            return Quantize(std::ceil(min * SCALE) / SCALE);
+        }
+        return result;
+    }
+
+    constexpr std::int32_t GetRaw() const noexcept {
+        return raw_;
+    }
+
+    constexpr double ToDouble() const noexcept {
+        return double(raw_) / SCALE;
+    }
+
+    constexpr auto operator<=>(const Fixed&) const = default;
+
+private:
+    std::int32_t raw_ = 0;
+};
+
+}  // namespace util
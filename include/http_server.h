@@ -10,6 +10,8 @@
 
 #include "logging_request_handler.h"
 #include "json_loader.h"
+#include "static_cache.h"
+#include "metrics.h"
 
 #include <iostream>
 
@@ -33,6 +35,7 @@ public:
 protected:
     explicit SessionBase(tcp::socket&& socket)
         : stream_(std::move(socket)) {
+        metrics::Registry::Instance().ConnectionOpened();
     }
 
     template <typename Body, typename Fields>
@@ -46,13 +49,18 @@ protected:
                           });
     }
 
+    // Большие статические файлы отправляются через sendfile, минуя буферы сериализатора
+    void Write(http_handler::SendfileResponse&& response);
+
     using HttpRequest = http::request<http::string_body>;
 
     auto GetEndpoint(){
         return stream_.socket().local_endpoint();
     }
 
-    ~SessionBase() = default;
+    ~SessionBase() {
+        metrics::Registry::Instance().ConnectionClosed();
+    }
 
 private:
     void Read() {
@@ -70,12 +78,7 @@ private:
         using namespace std::literals;
         if (ec == http::error::end_of_stream) {
             // Нормальная ситуация - клиент закрыл соединение
-            json_loader::json::value log{
-                {"data", 
-                    {{"code", 0}}
-                    },
-            };
-            BOOST_LOG_TRIVIAL(info) << logging::add_value(additional_data, log) << "server exited";
+            server_logging::AsyncLogger::Instance().LogConnectionClosed();
             return Close();
         }
         if (ec) {
@@ -104,6 +107,8 @@ private:
         stream_.socket().shutdown(tcp::socket::shutdown_send, ec);
     }
 
+    void SendFile(std::shared_ptr<http_handler::SendfileResponse> response, std::uint64_t offset);
+
     virtual void HandleRequest(HttpRequest&& request) = 0;
 
     virtual std::shared_ptr<SessionBase> GetSharedThis() = 0;
@@ -23,6 +23,9 @@ model::Game LoadGame(const std::filesystem::path& json_path);
 LootGeneratorProperties GetLootGenProp(const json::value& config);
 model::Speed GetDefaultDogSpeed(const json::value& config);
 int GetDefaultBagCapacity(const json::value& config);
+int GetMaxPlayersPerSession(const json::value& config);
+int GetDogRetirementTime(const json::value& config);
+bool GetFixedPointCoordinates(const json::value& config);
 model::Map LoadMap(const json::value& json_map, model::Speed default_dog_speed, int default_bag_capacity);
 void AddRoadToMap(model::Map& map, const json::value& json_map);
 void AddBuildingsToMap(model::Map& map, const json::value& json_map);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace json_writer {
+
+/*
+ * Потоковая запись JSON прямо в строку, без промежуточного DOM.
+ * Запятые и двоеточия расставляются сами, вызывающий отвечает только за парность Begin/End.
+ * Числа форматируются через std::to_chars, бесконечности и NaN записываются как null.
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) noexcept
+        : out_(out) {
+    }
+
+    JsonWriter& BeginObject();
+    JsonWriter& EndObject();
+    JsonWriter& BeginArray();
+    JsonWriter& EndArray();
+
+    JsonWriter& Key(std::string_view key);
+    // числовой ключ, например id игрока
+    JsonWriter& Key(std::uint64_t key);
+
+    JsonWriter& String(std::string_view value);
+    JsonWriter& Int(std::int64_t value);
+    JsonWriter& Double(double value);
+    JsonWriter& Bool(bool value);
+    JsonWriter& Null();
+
+private:
+    constexpr static size_t MAX_DEPTH = 32;
+
+    void BeforeValue();
+    void Open(char bracket);
+    void Close(char bracket);
+    void WriteString(std::string_view value);
+
+    std::string& out_;
+    // есть ли уже элементы в открытых объектах и массивах, нужно для запятых
+    std::array<bool, MAX_DEPTH> has_items_{};
+    size_t depth_ = 0;
+    bool after_key_ = false;
+};
+
+}  // namespace json_writer
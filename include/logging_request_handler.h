@@ -7,6 +7,9 @@
 #include <boost/beast/http.hpp>
 
 #include "logging.h"
+#include "async_logger.h"
+#include "access_log_policy.h"
+#include "metrics.h"
 
 namespace server_logging{
 
@@ -37,19 +40,29 @@ static std::string GetTimestamp() {
 template<class RequestHandler>
 class LoggingRequestHandler {
 public:
-    LoggingRequestHandler(RequestHandler handler)
-        : decorated_(std::move(handler)){
+    LoggingRequestHandler(RequestHandler handler, AccessLogPolicy policy = {})
+        : decorated_(std::move(handler))
+        , policy_(std::make_shared<const AccessLogPolicy>(std::move(policy))){
     }
     
     template <typename Body, typename Allocator, typename Send>
     void operator ()(tcp::endpoint ep, http::request<Body, http::basic_fields<Allocator>>&& req, Send&& send){
         auto start_ts = Clock::now();
 
-        LogRequest(ep, req);
+        // решение о записи принимается до того, как запись начнёт собираться
+        const bool sampled = policy_->ShouldLogRequest(req.target());
+        if (sampled) {
+            LogRequest(ep, req);
+        }
 
-        auto send_wrapper = [send = std::forward<Send>(send), start_ts, ep](auto&& response){
+        const auto endpoint = metrics::ClassifyEndpoint(req.target());
+
+        auto send_wrapper = [send = std::forward<Send>(send), start_ts, ep, sampled, endpoint, policy = policy_.get()](auto&& response){
             auto end_ts = Clock::now();
-            LogResponse(ep, response, end_ts - start_ts);
+            metrics::Registry::Instance().RecordRequest(endpoint, response.result_int(), end_ts - start_ts);
+            if (policy->ShouldLogResponse(sampled, response.result_int(), end_ts - start_ts)) {
+                LogResponse(ep, response, end_ts - start_ts);
+            }
             send(std::forward<decltype(response)>(response));
         };
 
@@ -62,32 +75,21 @@ public:
 private:
     using Clock = std::chrono::system_clock;
 
+    // Запись только копируется в буфер потока, JSON собирает фоновый поток AsyncLogger
     template <typename Body, typename Allocator>
     static void LogRequest( const tcp::endpoint& ep, 
                             const http::request<Body, 
                             http::basic_fields<Allocator>>& req){
-        json::value data{
-            {"ip", ep.address().to_string()},
-            {"URI", req.target()},
-            {"method", req.method_string()}
-        };
-
-        BOOST_LOG_TRIVIAL(info) << logging::add_value(additional_data, data) << "request received";
-
+        AsyncLogger::Instance().LogRequest(ep.address(), req.target(), req.method());
     }
 
     template <class T>
     static void LogResponse(const tcp::endpoint& ep,
                             const http::response<T>& res,
                             Clock::duration dur){
-        json::value data{
-            {"ip", ep.address().to_string()},
-            {"response_time", dur.count() / 100000},
-            {"code", res.result_int()},
-            {"content_type", res[http::field::content_type]}
-        };
-        BOOST_LOG_TRIVIAL(info) << logging::add_value(additional_data, data) << "response sent";
+        AsyncLogger::Instance().LogResponse(ep.address(), dur, res.result_int(), res[http::field::content_type]);
     }
     RequestHandler decorated_;
+    std::shared_ptr<const AccessLogPolicy> policy_;
 };
 } // namespace server_logging
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace metrics {
+
+/*
+ *  Гистограмма с логарифмически-линейными корзинами (как в HdrHistogram):
+ *  значения до 8 мкс хранятся точно, дальше каждая степень двойки делится на 4 корзины,
+ *  т.е. относительная погрешность не больше 25%. Значения больше MAX_VALUE попадают только в +Inf.
+ *  Пишет в гистограмму всегда один поток, поэтому достаточно relaxed load/store без RMW.
+ */
+class Histogram {
+public:
+    constexpr static size_t SUB_BUCKETS = 4;
+    constexpr static size_t LINEAR_BUCKETS = 2 * SUB_BUCKETS;
+    constexpr static size_t BUCKET_COUNT = 96;
+
+    struct Snapshot {
+        std::array<std::uint64_t, BUCKET_COUNT> buckets{};
+        std::uint64_t count = 0;
+        std::uint64_t sum = 0;
+    };
+
+    static size_t BucketIndex(std::uint64_t value) noexcept;
+    // наибольшее значение, попадающее в корзину
+    static std::uint64_t BucketUpperBound(size_t index) noexcept;
+
+    void Record(std::uint64_t value) noexcept;
+    void AddTo(Snapshot& snapshot) const noexcept;
+
+private:
+    static void Increment(std::atomic<std::uint64_t>& counter, std::uint64_t value = 1) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<std::uint64_t>, BUCKET_COUNT> buckets_{};
+    std::atomic<std::uint64_t> count_ = 0;
+    std::atomic<std::uint64_t> sum_ = 0;
+};
+
+enum class Endpoint : std::uint8_t {
+    JOIN_GAME,
+    PLAYER_LIST,
+    GAME_STATE,
+    GAME_TICK,
+    PLAYER_ACTION,
+    MAPS,
+    METRICS,
+    OTHER_API,
+    STATIC,
+    COUNT
+};
+
+Endpoint ClassifyEndpoint(std::string_view target) noexcept;
+std::string_view GetEndpointName(Endpoint endpoint) noexcept;
+
+/*
+ *  Реестр метрик сервера.
+ *  Каждый поток пишет в собственный набор счётчиков, при запросе /metrics они суммируются,
+ *  поэтому запись не создаёт конкуренции между потоками.
+ */
+class Registry {
+public:
+    static Registry& Instance();
+
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+
+    void RecordRequest(Endpoint endpoint, unsigned code, std::chrono::nanoseconds duration) noexcept;
+    void RecordTick(std::chrono::nanoseconds duration, std::chrono::nanoseconds lag) noexcept;
+    void RecordMissedTicks(std::uint64_t count) noexcept;
+    void ConnectionOpened() noexcept;
+    void ConnectionClosed() noexcept;
+
+    // дописывает в out метрики в текстовом формате Prometheus
+    void Format(std::string& out);
+
+private:
+    constexpr static size_t ENDPOINT_COUNT = size_t(Endpoint::COUNT);
+    constexpr static size_t STATUS_CLASSES = 5; // 1xx..5xx
+
+    struct ThreadMetrics {
+        std::array<std::array<std::atomic<std::uint64_t>, STATUS_CLASSES>, ENDPOINT_COUNT> requests{};
+        std::array<Histogram, ENDPOINT_COUNT> request_durations;
+        Histogram tick_durations;
+        Histogram tick_lags;
+        std::atomic<std::uint64_t> ticks_missed = 0;
+        std::atomic<std::uint64_t> connections_opened = 0;
+        std::atomic<std::uint64_t> connections_closed = 0;
+    };
+
+    Registry() = default;
+    ThreadMetrics& Local();
+
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<ThreadMetrics>> threads_;
+};
+
+// Вспомогательные функции форматирования для метрик, собираемых вне реестра
+void AppendHelp(std::string& out, std::string_view name, std::string_view type, std::string_view help);
+void AppendSample(std::string& out, std::string_view name, std::string_view labels, double value);
+void AppendHistogram(std::string& out, std::string_view name, std::string_view labels,
+                     const Histogram::Snapshot& snapshot, double unit);
+
+}  // namespace metrics
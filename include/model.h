@@ -1,11 +1,18 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <list>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <deque>
 #include <set>
+#include <span>
 
+#include "slot_map.h"
 #include "tagged.h"
 
 namespace model {
@@ -44,6 +51,24 @@ struct DogSpeed {
     Speed vx, vy;
 };
 
+enum class Direction : std::uint8_t {
+    LEFT,
+    RIGHT,
+    UP,
+    DOWN
+};
+
+// обозначения направлений в API, в порядке Direction
+constexpr std::string_view DIRECTION_NAMES = "LRUD";
+
+constexpr std::string_view GetDirectionName(Direction dir) noexcept {
+    return DIRECTION_NAMES.substr(size_t(dir), 1);
+}
+
+constexpr bool IsHorizontal(Direction dir) noexcept {
+    return dir == Direction::LEFT || dir == Direction::RIGHT;
+}
+
 class Road {
     struct HorizontalTag {
         explicit HorizontalTag() = default;
@@ -150,8 +175,16 @@ private:
     Offset offset_;
 };
 
+// Описание типа трофея. Заполняется один раз при загрузке конфига,
+// чтобы при ответах и подсчёте очков не разбирать строки.
 struct LootType {
-    std::unordered_map<std::string, std::string> parameters;
+    std::string name;
+    std::string file;
+    std::string type;
+    std::optional<int> rotation;
+    std::optional<std::string> color;
+    std::optional<double> scale;
+    int value = 0;
 };
 
 struct LootState
@@ -199,6 +232,13 @@ public:
 
     void AddRoad(const Road& road);
 
+    /*
+     * Точка на дорогах карты, равномерно распределённая по их площади.
+     * along и across - доли в [0, 1): вдоль суммарной длины всех дорог и поперёк выбранной дороги.
+     * Дорога находится двоичным поиском по накопленным длинам, т.е. за O(log R).
+     */
+    DogPosition GetPointOnRoads(double along, double across) const;
+
     void AddBuilding(const Building& building) {
         buildings_.emplace_back(building);
     }
@@ -232,26 +272,85 @@ private:
     Id id_;
     std::string name_;
     Roads roads_;
+    // дороги в порядке добавления и накопленные суммы их длин с учётом ширины
+    std::vector<Road> sampled_roads_;
+    std::vector<double> cumulative_lengths_;
     Buildings buildings_;
     Speed dog_speed_;
-    int bag_capacity_;
+    int bag_capacity_ = 0;
     LootTypes loot_types_;
 
     OfficeIdToIndex warehouse_id_to_index_;
     Offices offices_;
 };
 
+struct BagItem {
+    int id;
+    int type;
+};
+
+/*
+ * Рюкзак собаки. Вместимость задаётся картой и обычно мала, поэтому предметы лежат прямо в объекте.
+ * Только если карта разрешает больше INLINE_CAPACITY предметов, память выделяется один раз при создании.
+ */
+class Bag {
+public:
+    constexpr static size_t INLINE_CAPACITY = 8;
+
+    explicit Bag(size_t capacity)
+        : capacity_(capacity) {
+        if (capacity_ > INLINE_CAPACITY) {
+            spilled_items_.resize(capacity_);
+        }
+    }
+
+    // false, если рюкзак полон
+    bool Add(BagItem item) noexcept {
+        if (IsFull()) {
+            return false;
+        }
+        Data()[size_++] = item;
+        return true;
+    }
+
+    void Clear() noexcept {
+        size_ = 0;
+    }
+
+    bool IsFull() const noexcept {
+        return size_ >= capacity_;
+    }
+
+    std::span<const BagItem> GetItems() const noexcept {
+        return {Data(), size_};
+    }
+
+private:
+    BagItem* Data() noexcept {
+        return capacity_ > INLINE_CAPACITY ? spilled_items_.data() : inline_items_.data();
+    }
+
+    const BagItem* Data() const noexcept {
+        return capacity_ > INLINE_CAPACITY ? spilled_items_.data() : inline_items_.data();
+    }
+
+    std::array<BagItem, INLINE_CAPACITY> inline_items_;
+    std::vector<BagItem> spilled_items_;
+    size_t capacity_;
+    size_t size_ = 0;
+};
+
 class Dog {
 public:
     using Id = util::Tagged<uint32_t, Dog>;
-    using Bag = std::unordered_map<int,int>;
-    Dog(std::string name, uint32_t id) 
-        : name_(name)
+    Dog(std::string name, uint32_t id, size_t bag_capacity) 
+        : name_(std::move(name))
         , id_(id)
         , speed_{0.0, 0.0} 
+        , bag_(bag_capacity)
         {}
 
-    std::string GetName() {
+    std::string_view GetName() const noexcept {
         return name_;
     }
 
@@ -259,7 +358,7 @@ public:
         return id_;
     }
 
-    std::string GetDirection() const {
+    Direction GetDirection() const noexcept {
         return dir_;
     }
 
@@ -271,7 +370,7 @@ public:
         return speed_;
     }
 
-    void SetDirection(std::string dir) {
+    void SetDirection(Direction dir) noexcept {
         dir_ = dir;
     }
 
@@ -285,69 +384,126 @@ public:
         speed_.vy = vy;
     }
 
-    void AddLoot(const LootState& loot) {
-        bag_[loot.id] = loot.type;
+    // false, если рюкзак полон
+    bool AddLoot(const LootState& loot) noexcept {
+        return bag_.Add({loot.id, loot.type});
+    }
+
+    bool IsBagFull() const noexcept {
+        return bag_.IsFull();
     }
 
-    Bag GetBag() const {
-        return bag_;
+    std::span<const BagItem> GetBag() const noexcept {
+        return bag_.GetItems();
     }
 
-    void BagClear() {
-        bag_.clear();
+    void BagClear() noexcept {
+        bag_.Clear();
+    }
+
+    int GetScore() const noexcept {
+        return score_;
+    }
+
+    void AddScore(int score) noexcept {
+        score_ += score;
+    }
+
+    // время, которое собака простояла без движения
+    std::chrono::milliseconds GetIdleTime() const noexcept {
+        return idle_time_;
+    }
+
+    void AddIdleTime(std::chrono::milliseconds delta) noexcept {
+        idle_time_ += delta;
+    }
+
+    void ResetIdleTime() noexcept {
+        idle_time_ = {};
     }
 
 private:
     std::string name_;
-    std::string dir_ = "U";
+    Direction dir_ = Direction::UP;
     DogPosition pos_;
     DogSpeed speed_;
     Bag bag_;
     Id id_;
+    int score_ = 0;
+    std::chrono::milliseconds idle_time_{};
 };
 
 class GameSession {
 public:
-    GameSession(Map& map) : map_(map){}
-    Dog& AddPlayer(std::string name);
+    // собаки и трофеи удаляются из середины, а тик обходит их подряд, поэтому хранятся в slot map
+    using Dogs = util::SlotMap<Dog>;
+    using DogHandle = Dogs::Handle;
+    using Loot = util::SlotMap<LootState>;
+    using LootHandle = Loot::Handle;
+
+    GameSession(Map& map, uint32_t id) : map_(map), id_(id){}
+    // игроки ссылаются на сессию, поэтому она не копируется и не перемещается
+    GameSession(const GameSession&) = delete;
+    GameSession& operator=(const GameSession&) = delete;
+    GameSession(GameSession&&) = delete;
+    GameSession& operator=(GameSession&&) = delete;
 
-    void AddLoot(LootState loot);
+    DogHandle AddPlayer(std::string name);
+    bool RemoveDog(DogHandle handle);
+
+    LootHandle AddLoot(LootState loot);
+    bool RemoveLoot(LootHandle handle);
 
     const Map::Id& GetMapId() {
         return map_.GetId();
     }
 
+    // номер сессии в игре, не меняется при удалении других сессий
+    uint32_t GetId() const noexcept {
+        return id_;
+    }
+
     Map& GetMap() const noexcept {
         return map_;
     }
 
-    std::deque<Dog>& GetDogs() {
+    // nullptr, если собака уже удалена
+    Dog* FindDog(DogHandle handle) noexcept {
+        return dogs_.Find(handle);
+    }
+
+    Dogs& GetDogs() {
         return dogs_;
     }
 
-    std::deque<LootState>& GetLoot() {
+    Loot& GetLoot() {
         return loot_;
     }
 
     uint32_t GetPlayersCount() const noexcept {
-        return players_counter_;
+        return uint32_t(dogs_.size());
     }
 
     uint32_t GetLootCount() const noexcept {
-        return loot_counter_;
+        return uint32_t(loot_.size());
     }
 private:
-    std::deque<Dog> dogs_;
-    std::deque<LootState> loot_;
+    Dogs dogs_;
+    Loot loot_;
     Map& map_;
+    uint32_t id_;
+    // id для клиентов не переиспользуются, в отличие от слотов
     uint32_t players_counter_ = 0;
     uint32_t loot_counter_ = 0;
 };
 
 class Game {
 public:
-    using Maps = std::vector<Map>;
-    using Sessions = std::vector<GameSession>;
+    // deque не перемещает элементы при добавлении в конец, поэтому ссылки на карты,
+    // которые хранят сессии, остаются действительными.
+    // Сессии ещё и удаляются из середины, поэтому лежат в list
+    using Maps = std::deque<Map>;
+    using Sessions = std::list<GameSession>;
 
     void AddMap(Map map);
 
@@ -361,17 +517,18 @@ public:
         return sessions_;
     }
 
-    GameSession& FindSession(const Map::Id& id) {
-        // поиск сессии
-        for (auto&& session : sessions_){
-            if(id == session.GetMapId()) {
-                return session;
-            }
-        }
-        // Если открытой сессии не нашлось, то нужно создать новую и отдать.
-        sessions_.emplace_back(GameSession(maps_[map_id_to_index_.at(id)]));
-        return sessions_.back();
-    }
+    /*
+     * Возвращает сессию карты для нового игрока.
+     * Если задан максимум игроков в сессии, игрок попадает в наименее заполненную сессию карты,
+     * а когда заполнены все - для карты открывается ещё одна сессия.
+     */
+    GameSession& FindSession(const Map::Id& id);
+
+    // открывает для карты ещё одну сессию
+    GameSession& AddSession(const Map::Id& id);
+
+    // удаляет сессию, ссылки на неё становятся недействительными
+    void RemoveSession(const GameSession& session);
 
     void SetLootGenPeriod(int milliseconds) {
         loot_generating_period_ = milliseconds;
@@ -388,16 +545,46 @@ public:
     double GetLootGenProbability() const noexcept {
         return loot_generating_probability_;
     }
+
+    void SetMaxPlayersPerSession(int max_players) {
+        max_players_per_session_ = max_players;
+    }
+
+    int GetMaxPlayersPerSession() const noexcept {
+        return max_players_per_session_;
+    }
+
+    void SetDogRetirementTime(int milliseconds) {
+        dog_retirement_time_ = milliseconds;
+    }
+
+    int GetDogRetirementTime() const noexcept {
+        return dog_retirement_time_;
+    }
+
+    void SetFixedPointCoordinates(bool is_fixed_point) {
+        is_fixed_point_coordinates_ = is_fixed_point;
+    }
+
+    bool IsFixedPointCoordinates() const noexcept {
+        return is_fixed_point_coordinates_;
+    }
     
 private:
     using MapIdHasher = util::TaggedHasher<Map::Id>;
     using MapIdToIndex = std::unordered_map<Map::Id, size_t, MapIdHasher>;
+    using MapIdToSessions = std::unordered_map<Map::Id, std::vector<GameSession*>, MapIdHasher>;
 
     Maps maps_;
     MapIdToIndex map_id_to_index_;
     Sessions sessions_;
+    MapIdToSessions sessions_by_map_id_;
+    uint32_t sessions_counter_ = 0;
 
     int loot_generating_period_;
     double loot_generating_probability_;
+    int max_players_per_session_ = 0;
+    int dog_retirement_time_ = 0;
+    bool is_fixed_point_coordinates_ = false;
 };
 }  // namespace model
@@ -11,21 +11,24 @@ namespace player {
 
 using GameSession = model::GameSession;
 using Dog = model::Dog;
+using DogHandle = GameSession::DogHandle;
 
 
 class Player{
 public:
     using Id = util::Tagged<uint32_t, Player>;
-    Player(Id id, GameSession& session, Dog& dog);
+    Player(Id id, GameSession& session, DogHandle dog, Dog::Id dog_id);
 
-    Id GetId() { return id_;}
+    Id GetId() const { return id_;}
 
     Dog::Id GetDogId() const {
-        return dog_.GetId();
+        return dog_id_;
     }
 
-    Dog& GetDog() const {
-        return dog_;
+    // ссылку на собаку хранить нельзя - slot map перемещает элементы, поэтому собака ищется по дескриптору.
+    // nullptr, если собака уже удалена из сессии
+    Dog* GetDog() const {
+        return session_.FindDog(dog_);
     }
 
     GameSession& GetSession() const {
@@ -34,8 +37,9 @@ public:
     
 private:
     Id id_;
-    Dog& dog_; 
     GameSession& session_;
+    DogHandle dog_;
+    Dog::Id dog_id_;
 
 };
 
@@ -43,9 +47,26 @@ class Players{
 public:
     using PlayerById = std::unordered_map<Player::Id, Player, util::TaggedHasher<Player::Id>>;
 
-    Player& AddPlayer(GameSession& session, Dog& dog);
+    Player& AddPlayer(GameSession& session, DogHandle dog);
+    Player* FindPlayerByDog(const GameSession& session, Dog::Id dog_id);
+    void RemovePlayer(Player::Id id);
 private:
+    // id собак уникальны только внутри сессии
+    struct DogKey {
+        const GameSession* session;
+        Dog::Id dog_id;
+
+        bool operator==(const DogKey&) const = default;
+    };
+
+    struct DogKeyHasher {
+        size_t operator()(const DogKey& key) const noexcept {
+            return std::hash<const void*>{}(key.session) * 37 + *key.dog_id;
+        }
+    };
+
     PlayerById player_by_id_;
+    std::unordered_map<DogKey, Player::Id, DogKeyHasher> player_by_dog_;
     uint32_t player_counter_ = 0;
 };
 
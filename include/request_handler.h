@@ -4,6 +4,7 @@
 #include "http_server.h"
 #include "application.h"
 #include "api_handler.h"
+#include "static_cache.h"
 
 
 namespace http_handler {
@@ -25,14 +26,12 @@ using StringRequest = http::request<http::string_body>;
 // Ответ, тело которого представлено в виде строки
 using StringResponse = http::response<http::string_body>;
 
-// Ответ, тело которого представлено в виде файла
-using FileResponse = http::response<http::file_body>;
-
 struct ContentType {
     ContentType() = delete;
     constexpr static std::string_view TEXT_HTML = "text/html"sv;
     constexpr static std::string_view TEXT_CSS = "text/css"sv;
     constexpr static std::string_view TEXT_PLAIN = "text/plain"sv;
+    constexpr static std::string_view TEXT_PROMETHEUS = "text/plain; version=0.0.4"sv;
     constexpr static std::string_view TEXT_JS = "text/javascript"sv;
     constexpr static std::string_view APP_JSON = "application/json"sv;
     constexpr static std::string_view APP_XML = "application/xml"sv;
@@ -72,8 +71,19 @@ public:
                     }
                 };
                 return net::dispatch(api_strand_, handle);
+            } else if (req.target() == Endpoint::METRICS) {
+                // метрики игры читаются из состояния, которое меняется только на api strand
+                auto handle = [self = shared_from_this(), send, version, keep_alive]{
+                    send(self->MakeMetricsResponse(version, keep_alive));
+                };
+                return net::dispatch(api_strand_, handle);
+            } else if (req.target() == Endpoint::TICK_TRACE) {
+                auto handle = [self = shared_from_this(), send, version, keep_alive]{
+                    send(self->MakeTickTraceResponse(version, keep_alive));
+                };
+                return net::dispatch(api_strand_, handle);
             } else {
-                send(MakeFileResponse(req));
+                static_files_.Serve(req, send);
             }
         } catch (...) {
             send(ReportServerError(version, keep_alive));
@@ -84,11 +94,11 @@ private:
     std::vector<std::string> ParseTarget(std::string_view target) const;
     
     StringResponse ReportServerError(unsigned version, bool keep_alive) const;
-    FileResponse MakeFileResponse(const StringRequest& req) const;
-
-    std::string_view GetContentType(std::string_view file_extention) const;
+    StringResponse MakeMetricsResponse(unsigned version, bool keep_alive);
+    StringResponse MakeTickTraceResponse(unsigned version, bool keep_alive);
 
-    fs::path root_path_;
+    StaticFileCache static_files_;
+    Application& app_;
     Strand& api_strand_;
     ApiHandler api_handler_;
 };
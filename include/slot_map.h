@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+/**
+ * Контейнер с поколениями ("slot map").
+ * Элементы лежат плотно в одном векторе, поэтому обход идёт без пропусков, а вставка и удаление
+ * выполняются за O(1): при удалении на место элемента переносится последний.
+ * Доступ к элементу - по дескриптору (индекс слота + поколение). При удалении поколение слота
+ * увеличивается, поэтому дескриптор удалённого элемента больше ничего не находит,
+ * даже если слот занят новым элементом.
+ *
+ * Ссылки и указатели на элементы действительны только до следующей вставки или удаления,
+ * для долгого хранения используется Handle.
+ */
+template <typename T>
+class SlotMap {
+    constexpr static std::uint32_t NO_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+public:
+    struct Handle {
+        std::uint32_t index = NO_INDEX;
+        std::uint32_t generation = 0;
+
+        bool operator==(const Handle&) const = default;
+    };
+
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    template <typename... Args>
+    Handle Emplace(Args&&... args) {
+        std::uint32_t slot_index;
+        if (free_head_ != NO_INDEX) {
+            slot_index = free_head_;
+            free_head_ = slots_[slot_index].position;
+        } else {
+            slot_index = std::uint32_t(slots_.size());
+            slots_.push_back({});
+        }
+        values_.emplace_back(std::forward<Args>(args)...);
+        value_slots_.push_back(slot_index);
+        slots_[slot_index].position = std::uint32_t(values_.size() - 1);
+        return {slot_index, slots_[slot_index].generation};
+    }
+
+    Handle Insert(T value) {
+        return Emplace(std::move(value));
+    }
+
+    // возвращает false, если элемент уже удалён
+    bool Erase(Handle handle) {
+        if (!Contains(handle)) {
+            return false;
+        }
+        Slot& slot = slots_[handle.index];
+        const std::uint32_t position = slot.position;
+        const std::uint32_t last = std::uint32_t(values_.size() - 1);
+        if (position != last) {
+            values_[position] = std::move(values_[last]);
+            value_slots_[position] = value_slots_[last];
+            slots_[value_slots_[position]].position = position;
+        }
+        values_.pop_back();
+        value_slots_.pop_back();
+
+        ++slot.generation;
+        slot.position = free_head_;
+        free_head_ = handle.index;
+        return true;
+    }
+
+    bool Contains(Handle handle) const noexcept {
+        return handle.index < slots_.size() && slots_[handle.index].generation == handle.generation
+            && !IsFree(handle.index);
+    }
+
+    T* Find(Handle handle) noexcept {
+        return Contains(handle) ? &values_[slots_[handle.index].position] : nullptr;
+    }
+
+    const T* Find(Handle handle) const noexcept {
+        return Contains(handle) ? &values_[slots_[handle.index].position] : nullptr;
+    }
+
+    // дескриптор элемента, стоящего на позиции position при обходе
+    Handle GetHandle(std::size_t position) const noexcept {
+        const std::uint32_t slot_index = value_slots_[position];
+        return {slot_index, slots_[slot_index].generation};
+    }
+
+    std::size_t size() const noexcept {
+        return values_.size();
+    }
+
+    bool empty() const noexcept {
+        return values_.empty();
+    }
+
+    T& operator[](std::size_t position) noexcept {
+        return values_[position];
+    }
+
+    const T& operator[](std::size_t position) const noexcept {
+        return values_[position];
+    }
+
+    iterator begin() noexcept {
+        return values_.begin();
+    }
+    iterator end() noexcept {
+        return values_.end();
+    }
+    const_iterator begin() const noexcept {
+        return values_.begin();
+    }
+    const_iterator end() const noexcept {
+        return values_.end();
+    }
+
+private:
+    struct Slot {
+        // позиция элемента в values_, у свободного слота - следующий свободный слот
+        std::uint32_t position = NO_INDEX;
+        std::uint32_t generation = 0;
+    };
+
+    bool IsFree(std::uint32_t slot_index) const noexcept {
+        const std::uint32_t position = slots_[slot_index].position;
+        return position >= value_slots_.size() || value_slots_[position] != slot_index;
+    }
+
+    std::vector<Slot> slots_;
+    std::vector<T> values_;
+    // слот каждого элемента values_
+    std::vector<std::uint32_t> value_slots_;
+    std::uint32_t free_head_ = NO_INDEX;
+};
+
+}  // namespace util
@@ -0,0 +1,235 @@
+#pragma once
+
+#define BOOST_BEAST_USE_STD_STRING_VIEW
+
+#include <ctime>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include "constants.h"
+
+namespace http_handler {
+
+namespace net = boost::asio;
+namespace fs = std::filesystem;
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+/*
+ * Тело ответа, разделяющее содержимое закэшированного файла между всеми ответами.
+ * В отличие от string_body не копирует файл на каждый запрос.
+ */
+struct CachedBody {
+    using value_type = std::shared_ptr<const std::string>;
+
+    static std::uint64_t size(const value_type& body) {
+        return body ? body->size() : 0;
+    }
+
+    class writer {
+    public:
+        using const_buffers_type = net::const_buffer;
+
+        template <bool isRequest, class Fields>
+        explicit writer(const http::header<isRequest, Fields>&, const value_type& body)
+            : body_(body) {
+        }
+
+        void init(beast::error_code& ec) {
+            ec = {};
+        }
+
+        boost::optional<std::pair<const_buffers_type, bool>> get(beast::error_code& ec) {
+            ec = {};
+            if (!body_ || body_->empty()) {
+                return boost::none;
+            }
+            return {{const_buffers_type{body_->data(), body_->size()}, false}};
+        }
+
+    private:
+        const value_type& body_;
+    };
+};
+
+/*
+ * Тело ответа для больших файлов. Отдельный тип нужен, чтобы сессия могла
+ * отправить его через sendfile, не копируя файл в пространство пользователя.
+ * Хранит открытый файл и отправляемый диапазон байт (для ответов 206).
+ * На платформах без sendfile сериализуется обычным чтением файла по кускам.
+ */
+struct SendfileBody {
+    struct value_type {
+        beast::file file;
+        std::uint64_t offset = 0;
+        std::uint64_t size = 0;
+    };
+
+    static std::uint64_t size(const value_type& body) {
+        return body.size;
+    }
+
+    class writer {
+    public:
+        using const_buffers_type = net::const_buffer;
+
+        template <bool isRequest, class Fields>
+        explicit writer(const http::header<isRequest, Fields>&, value_type& body)
+            : body_(body) {
+        }
+
+        void init(beast::error_code& ec) {
+            remain_ = body_.size;
+            body_.file.seek(body_.offset, ec);
+        }
+
+        boost::optional<std::pair<const_buffers_type, bool>> get(beast::error_code& ec) {
+            const auto amount = std::min<std::uint64_t>(remain_, sizeof(buffer_));
+            if (amount == 0) {
+                ec = {};
+                return boost::none;
+            }
+            const auto read = body_.file.read(buffer_, size_t(amount), ec);
+            if (ec) {
+                return boost::none;
+            }
+            if (read == 0) {
+                ec = http::error::short_read;
+                return boost::none;
+            }
+            remain_ -= read;
+            return {{const_buffers_type{buffer_, read}, remain_ > 0}};
+        }
+
+    private:
+        value_type& body_;
+        std::uint64_t remain_ = 0;
+        char buffer_[4096];
+    };
+};
+
+using CachedResponse = http::response<CachedBody>;
+using SendfileResponse = http::response<SendfileBody>;
+using StringRequest = http::request<http::string_body>;
+
+/*
+ *  Кэш статических файлов.
+ *  Дерево www-root сканируется один раз при старте: небольшие файлы читаются в память
+ *  вместе с готовыми заголовками, для больших запоминается только путь и размер.
+ *  Для текстовых файлов заранее готовится gzip-вариант (или берётся соседний файл .gz),
+ *  который отдаётся клиентам, принимающим Accept-Encoding: gzip.
+ */
+class StaticFileCache {
+public:
+    constexpr static std::uint64_t DEFAULT_MAX_CACHED_FILE_SIZE = 256 * 1024;
+
+    struct StaticFile {
+        fs::path path;
+        std::uint64_t size = 0;
+        std::time_t modified = 0;
+        // готовый ответ для файлов, хранящихся в памяти, у больших файлов тело пустое
+        CachedResponse response;
+        bool is_cached = false;
+        // сжатый вариант всегда хранится в памяти
+        std::optional<CachedResponse> gzip_response;
+    };
+
+    // Запрошенный диапазон байт. length == 0 - диапазон не пересекается с файлом (ответ 416)
+    struct ByteRange {
+        std::uint64_t offset = 0;
+        std::uint64_t length = 0;
+
+        bool operator==(const ByteRange&) const = default;
+    };
+
+    explicit StaticFileCache(const fs::path& root_path,
+                             std::uint64_t max_cached_file_size = DEFAULT_MAX_CACHED_FILE_SIZE);
+
+    // target - путь из запроса, допускается query-часть и %-кодирование
+    const StaticFile* Find(std::string_view target) const;
+
+    // проверяет, что путь из запроса не выходит за пределы www-root
+    static bool IsTargetInRoot(std::string_view target);
+
+    // проверяет, допускает ли заголовок Accept-Encoding ответ в gzip
+    static bool IsGzipAccepted(std::string_view accept_encoding);
+
+    // проверяет условия If-None-Match / If-Modified-Since для выбранного варианта файла
+    static bool IsNotModified(const StaticFile& file, const CachedResponse& prepared, const StringRequest& req);
+
+    // разбирает заголовок Range. Поддерживается только один диапазон,
+    // для нескольких диапазонов и некорректного заголовка возвращается nullopt - отдаётся весь файл
+    static std::optional<ByteRange> ParseRange(std::string_view range, std::uint64_t size);
+
+    // учитывает If-Range: если валидатор не совпал, диапазон игнорируется
+    static std::optional<ByteRange> GetRequestedRange(const StaticFile& file, const StringRequest& req);
+
+    CachedResponse MakeCachedResponse(const CachedResponse& prepared, unsigned version, bool keep_alive) const;
+    CachedResponse MakeNotModifiedResponse(const CachedResponse& prepared, unsigned version, bool keep_alive) const;
+    CachedResponse MakeCachedRangeResponse(const StaticFile& file, ByteRange range, unsigned version, bool keep_alive) const;
+    std::optional<SendfileResponse> MakeSendfileResponse(const StaticFile& file, std::optional<ByteRange> range,
+                                                         unsigned version, bool keep_alive) const;
+    CachedResponse MakeErrorResponse(http::status status, unsigned version, bool keep_alive) const;
+    CachedResponse MakeRangeNotSatisfiableResponse(const StaticFile& file, unsigned version, bool keep_alive) const;
+
+    template <typename Send>
+    void Serve(const StringRequest& req, Send&& send) const {
+        const auto version = req.version();
+        const auto keep_alive = req.keep_alive();
+        if (!IsTargetInRoot(req.target())) {
+            return send(MakeErrorResponse(http::status::bad_request, version, keep_alive));
+        }
+        const StaticFile* file = Find(req.target());
+        if (!file) {
+            return send(MakeErrorResponse(http::status::not_found, version, keep_alive));
+        }
+
+        // Диапазоны отдаются только из несжатого файла
+        auto range = GetRequestedRange(*file, req);
+        const bool use_gzip = !range && file->gzip_response && IsGzipAccepted(req[http::field::accept_encoding]);
+        const CachedResponse& prepared = use_gzip ? *file->gzip_response : file->response;
+        if (IsNotModified(*file, prepared, req)) {
+            return send(MakeNotModifiedResponse(prepared, version, keep_alive));
+        }
+        if (range && range->length == 0) {
+            return send(MakeRangeNotSatisfiableResponse(*file, version, keep_alive));
+        }
+
+        if (use_gzip || (file->is_cached && !range)) {
+            return send(MakeCachedResponse(prepared, version, keep_alive));
+        }
+        if (file->is_cached) {
+            return send(MakeCachedRangeResponse(*file, *range, version, keep_alive));
+        }
+        if (auto response = MakeSendfileResponse(*file, range, version, keep_alive)) {
+            return send(std::move(*response));
+        }
+        send(MakeErrorResponse(http::status::not_found, version, keep_alive));
+    }
+
+    size_t GetFilesCount() const noexcept {
+        return files_.size();
+    }
+
+    static std::string_view GetContentType(std::string_view file_extention);
+
+private:
+    static std::string DecodeTarget(std::string_view target);
+    static std::shared_ptr<const std::string> ReadFile(const fs::path& path);
+    static bool IsCompressible(std::string_view content_type);
+    void AddGzipVariant(StaticFile& file) const;
+
+    fs::path root_path_;
+    std::uint64_t max_cached_file_size_;
+    std::unordered_map<std::string, StaticFile> files_;
+    std::shared_ptr<const std::string> error_body_;
+};
+
+}  // namespace http_handler
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace profiling {
+
+enum class TickPhase : std::uint8_t {
+    TICK,
+    LOOT_GENERATION,
+    MOVEMENT,
+    GATHERING,
+    SERIALIZATION
+};
+
+constexpr size_t PHASE_COUNT = size_t(TickPhase::SERIALIZATION) + 1;
+
+std::string_view GetPhaseName(TickPhase phase) noexcept;
+
+/*
+ *  Профилировщик фаз игрового тика.
+ *  Хранит в кольцевом буфере записи о последних TICK_CAPACITY тиках: время каждой фазы
+ *  суммируется по всем сессиям, а сериализация ответов - по всем запросам до следующего тика,
+ *  поэтому число сессий и частота запросов не вытесняют историю.
+ *  Выгружает записи в формате Chrome trace_event (открывается в chrome://tracing или Perfetto).
+ *  Все замеры и выгрузка выполняются на api strand, поэтому буфер не синхронизируется.
+ */
+class TickProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    constexpr static size_t TICK_CAPACITY = 1024; // степень двойки
+
+    static TickProfiler& Instance();
+
+    TickProfiler(const TickProfiler&) = delete;
+    TickProfiler& operator=(const TickProfiler&) = delete;
+
+    // выключенный профилировщик стоит одной проверки флага на каждую фазу
+    static bool IsEnabled() noexcept {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+    static void SetEnabled(bool enabled) noexcept {
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    void BeginTick() noexcept {
+        ++tick_;
+        Current() = TickRecord{tick_};
+    }
+
+    void Record(TickPhase phase, Clock::time_point start, Clock::time_point end) noexcept;
+
+    // max_ticks - сколько последних тиков выгрузить
+    std::string DumpChromeTrace(std::uint64_t max_ticks = TICK_CAPACITY) const;
+
+private:
+    struct TickRecord {
+        std::uint64_t tick = 0;
+        Clock::time_point start;
+        // суммарное время фаз за тик
+        std::array<Clock::duration, PHASE_COUNT> durations{};
+        std::uint32_t serializations = 0;
+    };
+
+    constexpr static size_t MASK = TICK_CAPACITY - 1;
+    static_assert((TICK_CAPACITY & MASK) == 0, "Tick capacity must be a power of two");
+
+    TickProfiler() = default;
+
+    TickRecord& Current() noexcept {
+        return ticks_[tick_ & MASK];
+    }
+
+    static inline std::atomic<bool> enabled_ = false;
+
+    std::array<TickRecord, TICK_CAPACITY> ticks_{};
+    std::uint64_t tick_ = 0;
+    Clock::time_point origin_ = Clock::now();
+};
+
+// Замеряет время от создания до разрушения и записывает его как фазу текущего тика
+class ScopedPhase {
+public:
+    explicit ScopedPhase(TickPhase phase) noexcept
+        : phase_(phase)
+        , enabled_(TickProfiler::IsEnabled()) {
+        if (enabled_) {
+            start_ = TickProfiler::Clock::now();
+        }
+    }
+
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+    ~ScopedPhase() {
+        if (enabled_) {
+            TickProfiler::Instance().Record(phase_, start_, TickProfiler::Clock::now());
+        }
+    }
+
+private:
+    TickPhase phase_;
+    bool enabled_;
+    TickProfiler::Clock::time_point start_;
+};
+
+}  // namespace profiling
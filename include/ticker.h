@@ -1,3 +1,5 @@
+#pragma once
+
 #include <memory>
 #include <chrono>
 
@@ -10,15 +12,25 @@ namespace net = boost::asio;
 namespace sys = boost::system;
 using std::chrono::steady_clock;
 
+/*
+ *  Тикер с фиксированным шагом.
+ *  Таймер взводится на абсолютные моменты start + n * period, поэтому время работы обработчика
+ *  не накапливается в расписании. Обработчик всегда получает delta == period; если тик опоздал,
+ *  пропущенное время отрабатывается несколькими шагами, но не больше MAX_CATCH_UP_STEPS за раз,
+ *  остальное отбрасывается и учитывается в metrics::Registry как пропущенные тики.
+ */
 class Ticker : public std::enable_shared_from_this<Ticker> {
 public:
     using Strand = net::strand<net::io_context::executor_type>;
     using Handler = std::function<void(std::chrono::milliseconds delta)>;
 
+    constexpr static int MAX_CATCH_UP_STEPS = 5;
+
     Ticker(Strand& strand, std::chrono::milliseconds period, Handler handler);
         
 
     void Start();
+
 private:
     void ScheduleTick();
     void OnTick(sys::error_code ec);
@@ -27,5 +39,8 @@ private:
     net::steady_timer timer_;
     std::chrono::milliseconds period_;
     Handler handler_;
-    std::chrono::milliseconds last_tick_;
-};
\ No newline at end of file
+    steady_clock::time_point deadline_;
+    steady_clock::time_point last_tick_;
+    // время, прошедшее с последнего шага и ещё не переданное обработчику
+    steady_clock::duration accumulated_{};
+};
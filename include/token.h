@@ -47,6 +47,9 @@ public:
 
     Token AddPlayerToken(player::Player& player);
 
+    // отзывает токен игрока, вызывается до удаления самого игрока
+    void RemovePlayerToken(player::Player::Id player_id);
+
 private:
 // для токена
     std::random_device random_device_;
@@ -60,6 +63,7 @@ private:
     }()};
 
     PlayerByToken player_by_token_;
+    std::unordered_map<player::Player::Id, Token, util::TaggedHasher<player::Player::Id>> token_by_player_;
 };
 
 
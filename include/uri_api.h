@@ -22,6 +22,8 @@ using Token = security::PlayerTokens::Token;
 using FunctionWithAuthorize = std::function<http_handler::StringResponse(const Token&, std::string_view body)>;
 using FunctionWithoutAuthorize = std::function<http_handler::StringResponse(std::string_view body)>;
 using StringRequest = http::request<http::string_body>;
+// для обработчиков, которым нужны заголовки запроса
+using FunctionWithAuthorizeRequest = std::function<http_handler::StringResponse(const Token&, const StringRequest& req)>;
 
 
 class UriElement {
@@ -68,6 +70,7 @@ public:
     UriElement& SetNeedAuthorisation(bool need_authorize);
     UriElement& SetProcessFunction(FunctionWithAuthorize func);
     UriElement& SetProcessFunction(FunctionWithoutAuthorize func);
+    UriElement& SetProcessFunction(FunctionWithAuthorizeRequest func);
     UriElement& SetContentType(std::string_view type, std::string_view error_message);
     http_handler::StringResponse ProcessRequest(StringRequest req);
 
@@ -77,6 +80,7 @@ private:
     ContentType content_type_;
     FunctionWithAuthorize process_function_;
     FunctionWithoutAuthorize process_function_without_authorize_;
+    FunctionWithAuthorizeRequest process_function_with_request_;
 };
 
 class UriData {
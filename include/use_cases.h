@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <chrono>
 #include <limits>
+#include <utility>
+#include <vector>
 
 // #include <iostream> // TODO delete after tests
 
@@ -11,6 +14,11 @@
 #include "token.h"
 #include "constants.h"
 #include "loot_generator.h"
+#include "collision_detector.h"
+#include "json_writer.h"
+#include "binary_writer.h"
+#include "fixed_point.h"
+#include "tick_profiler.h"
 
 namespace app{
 using namespace std::literals;
@@ -100,8 +108,10 @@ struct PlayerState {
     player::Dog::Id id;
     model::DogPosition position;
     model::DogSpeed speed;
-    std::string direction;
-    model::Dog::Bag bag;
+    model::Direction direction;
+    // указывает в рюкзак собаки, поэтому состояние сериализуется до следующего тика
+    std::span<const model::BagItem> bag;
+    int score = 0;
 };
 
 struct GameState {
@@ -119,6 +129,41 @@ public:
     }
 };
 
+// ответ на запрос /api/v1/game/state, дописывается в out
+void SerializeGameState(const GameState& state, std::string& out);
+
+/*
+ * Двоичный формат ответов /game/state и /game/players, отдаётся по Accept: application/octet-stream.
+ * Числа little-endian без выравнивания, координаты и скорости - i32 с фиксированной точкой (значение * scale).
+ * Заголовок: u8 версия, u8 вид ответа, u16 scale, u32 число игроков.
+ * Состояние: u32 число предметов, затем игроки: u32 id, i32 x, i32 y, i32 vx, i32 vy,
+ *   u8 направление (индекс в "LRUD"), u32 очки, u16 число предметов в рюкзаке и сами они: u32 id, u16 тип;
+ *   затем предметы на карте: u32 id, u16 тип, i32 x, i32 y.
+ * Список игроков: u32 id, u16 длина имени, имя в UTF-8.
+ * Декодер для браузера - static/js/state_decoder.js.
+ */
+struct BinaryFormat {
+    BinaryFormat() = delete;
+    constexpr static uint8_t VERSION = 1;
+    constexpr static uint8_t GAME_STATE = 1;
+    constexpr static uint8_t PLAYERS_LIST = 2;
+    // совпадает с сеткой util::Fixed, поэтому в режиме фиксированной точки координаты передаются без потерь
+    constexpr static uint16_t SCALE = util::Fixed::SCALE;
+};
+
+void SerializeGameStateBinary(const GameState& state, std::string& out);
+
+// формат ответов /game/state и /game/players, выбирается по заголовку Accept
+enum class ResponseEncoding {
+    JSON,
+    BINARY
+};
+
+// Двоичный формат выбирается, только если application/octet-stream указан явно с q > 0
+// и с большим q, чем application/json. Шаблонам application/* и */* он не уступает при равном q.
+// Пустой заголовок и всё остальное - JSON.
+ResponseEncoding SelectResponseEncoding(std::string_view accept);
+
 class GameStateUseCase {
 public:
     explicit GameStateUseCase (Game& game, PlayerTokens& player_tokens);
@@ -133,12 +178,24 @@ class ListPlayersUseCase {
 public:
     ListPlayersUseCase(PlayerTokens& player_tokens) : player_tokens_(&player_tokens) {}
 
-    std::string GetPlayersList(const Player& player) {
-        json::object players_list;
-        for (auto& dog : player.GetSession().GetDogs()) {
-            players_list.emplace(std::to_string(*dog.GetId()), json::value{{"name", dog.GetName()}});
+    // список дописывается в out
+    void GetPlayersList(const Player& player, std::string& out) {
+        json_writer::JsonWriter writer(out);
+        writer.BeginObject();
+        for (const auto& dog : player.GetSession().GetDogs()) {
+            writer.Key(std::uint64_t(*dog.GetId())).BeginObject().Key("name").String(dog.GetName()).EndObject();
+        }
+        writer.EndObject();
+    }
+
+    void GetPlayersListBinary(const Player& player, std::string& out) {
+        const auto& dogs = player.GetSession().GetDogs();
+        binary_writer::BinaryWriter writer(out);
+        writer.U8(BinaryFormat::VERSION).U8(BinaryFormat::PLAYERS_LIST).U16(BinaryFormat::SCALE)
+            .U32(uint32_t(dogs.size()));
+        for (const auto& dog : dogs) {
+            writer.U32(*dog.GetId()).String(dog.GetName());
         }
-        return json::serialize(players_list);
     }
 private:
     PlayerTokens* player_tokens_;
@@ -185,6 +242,52 @@ struct MoveDistance
 };
 
 
+// собака, ушедшая из игры по бездействию; игрока и токен удаляет RetirePlayersUseCase
+struct RetiredDog {
+    model::GameSession* session;
+    model::Dog::Id dog_id;
+};
+
+/*
+ * Данные для сбора предметов в одной сессии: отрезки, пройденные собаками за тик, предметы и офисы.
+ * Сессии обрабатываются по очереди, поэтому один буфер переиспользуется для всех,
+ * и после прогрева сбор предметов не выделяет память.
+ * Предметы идут первыми, за ними - офисы.
+ */
+class GatheringScratch final : public collision_detector::ItemGathererProvider {
+public:
+    size_t ItemsCount() const override {
+        return items.size();
+    }
+
+    collision_detector::Item GetItem(size_t idx) const override {
+        return items[idx];
+    }
+
+    size_t GatherersCount() const override {
+        return gatherers.size();
+    }
+
+    collision_detector::Gatherer GetGatherer(size_t idx) const override {
+        return gatherers[idx];
+    }
+
+    void Clear() {
+        items.clear();
+        gatherers.clear();
+        events.clear();
+        is_collected.clear();
+        collected.clear();
+    }
+
+    // индекс собирателя совпадает с позицией собаки в сессии
+    std::vector<collision_detector::Gatherer> gatherers;
+    std::vector<collision_detector::Item> items;
+    std::vector<collision_detector::GatheringEvent> events;
+    std::vector<char> is_collected;
+    std::vector<model::GameSession::LootHandle> collected;
+};
+
 class UpdateGameStateUseCase {
 public:
     using Position = model::Position;
@@ -192,16 +295,33 @@ public:
     explicit UpdateGameStateUseCase(Game& game);
 
     void Update(const std::chrono::milliseconds& delta);
+    // продвигает игру на delta шагами не длиннее max_step, чтобы собаки не проскакивали перекрёстки.
+    // Шагов не больше MAX_TICK_SUBSTEPS: для очень длинных тиков шаг увеличивается
+    void Advance(std::chrono::milliseconds delta, std::chrono::milliseconds max_step);
+
+    static MoveDistance FindMoveDistance(const model::Roads& roads, const model::DogPosition& dog_pos, bool is_horizontal);
+
+    // собаки, удалённые из сессий с прошлого вызова
+    std::vector<RetiredDog> TakeRetiredDogs() {
+        return std::exchange(retired_dogs_, {});
+    }
 
 private:
     const double ROAD_WIDTH = 0.4;
     void UpdateSession(model::GameSession& session, const std::chrono::milliseconds& delta);
-    MoveDistance FindMoveDistance(model::Roads& roads, const model::DogPosition& dog_pos, bool is_horizontal);
+    void GatherLoot(model::GameSession& session);
+    void RetireIdleDogs(model::GameSession& session);
     void AddLootToSesssion(model::GameSession& session, const std::chrono::milliseconds& delta);
     model::LootPosition GetRandomLootPosition(model::GameSession& session);
 private:
     Game* game_;
     loot_gen::LootGenerator loot_generator_;
+    std::chrono::milliseconds dog_retirement_time_;
+    // за тик удаляется не больше MAX_RETIREMENTS_PER_TICK собак, остальные дождутся следующих тиков
+    int retirements_left_ = 0;
+    std::vector<model::GameSession::DogHandle> idle_dogs_;
+    GatheringScratch gathering_;
+    std::vector<RetiredDog> retired_dogs_;
 
     std::random_device random_device_;
     std::mt19937_64 generator_{[this] {
@@ -210,4 +330,18 @@ private:
     }()};
 };
 
+class RetirePlayersUseCase {
+public:
+    RetirePlayersUseCase(Game& game, Players& players, PlayerTokens& player_tokens);
+
+    // отзывает токены и удаляет игроков ушедших собак, затем - опустевшие сессии
+    void Retire(const std::vector<RetiredDog>& retired);
+
+private:
+    Game* game_;
+    Players* players_;
+    PlayerTokens* player_tokens_;
+    std::vector<model::GameSession*> sessions_;
+};
+
 } // namespace app
\ No newline at end of file
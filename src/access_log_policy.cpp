@@ -0,0 +1,77 @@
+#include "access_log_policy.h"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+namespace server_logging {
+
+using namespace std::literals;
+
+namespace {
+
+// Дешёвый генератор для прореживания: свой у каждого потока, без блокировок
+double NextRandom() {
+    thread_local std::minstd_rand generator{std::random_device{}()};
+    return std::generate_canonical<double, 32>(generator);
+}
+
+}  // namespace
+
+AccessLogPolicy::AccessLogPolicy(LogLevel min_level, std::vector<SampleRate> sample_rates,
+                                 std::chrono::milliseconds slow_threshold)
+        : min_level_(min_level)
+        , sample_rates_(std::move(sample_rates))
+        , slow_threshold_(slow_threshold) {
+    // более длинные префиксы проверяются первыми
+    std::stable_sort(sample_rates_.begin(), sample_rates_.end(), [](const SampleRate& l, const SampleRate& r) {
+        return l.route.size() > r.route.size();
+    });
+}
+
+bool AccessLogPolicy::ShouldLogRequest(std::string_view target) const {
+    if (min_level_ > LogLevel::INFO) {
+        return false;
+    }
+    if (sample_rates_.empty()) {
+        return true;
+    }
+    const double rate = FindRate(target);
+    if (rate >= 1.0) {
+        return true;
+    }
+    return rate > 0.0 && NextRandom() < rate;
+}
+
+double AccessLogPolicy::FindRate(std::string_view target) const {
+    const bool is_static = !target.starts_with("/api/"sv);
+    for (const auto& sample_rate : sample_rates_) {
+        if (sample_rate.route == STATIC_ROUTE ? is_static : target.starts_with(sample_rate.route)) {
+            return sample_rate.rate;
+        }
+    }
+    return 1.0;
+}
+
+LogLevel AccessLogPolicy::ParseLevel(std::string_view level) {
+    if (level == "trace"sv) return LogLevel::TRACE;
+    if (level == "debug"sv) return LogLevel::DEBUG;
+    if (level == "info"sv) return LogLevel::INFO;
+    if (level == "warning"sv) return LogLevel::WARNING;
+    if (level == "error"sv) return LogLevel::ERROR;
+    throw std::invalid_argument("Unknown log level: "s + std::string(level));
+}
+
+AccessLogPolicy::SampleRate AccessLogPolicy::ParseSampleRate(std::string_view sample_rate) {
+    const auto separator = sample_rate.rfind('=');
+    if (separator == std::string_view::npos || separator == 0) {
+        throw std::invalid_argument("Sample rate must be in form route=rate: "s + std::string(sample_rate));
+    }
+    const double rate = std::stod(std::string(sample_rate.substr(separator + 1)));
+    if (rate < 0.0 || rate > 1.0) {
+        throw std::invalid_argument("Sample rate must be in [0, 1]: "s + std::string(sample_rate));
+    }
+    return {std::string(sample_rate.substr(0, separator)), rate};
+}
+
+}  // namespace server_logging
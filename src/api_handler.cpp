@@ -59,9 +59,9 @@ StringResponse ApiHandler::HandleMapsRequest(const StringRequest& request){
     std::string json_body;
     if (request.method() == http::verb::get || request.method() == http::verb::head) {
         if (parsed_target.size() == 3){
-            json_body = app_.GetMapsSpec();   
+            app_.GetMapsSpec(json_body);
         } else if ( auto id = Map::Id(parsed_target[3]); auto map = app_.FindMap(id)){
-            json_body = app_.GetMapInfo(*map);
+            app_.GetMapInfo(*map, json_body);
         } else {
             json_body = R"({"code": "mapNotFound", "message": "Map not found"})"; 
             response.result(http::status::not_found);
@@ -72,8 +72,8 @@ StringResponse ApiHandler::HandleMapsRequest(const StringRequest& request){
         json_body = R"({"code": "invalidMethod", "message": "Only GET, HEAD method is expected"})"; 
     }
 
-    response.body() = json_body;
-    response.content_length(json_body.size());
+    response.body() = std::move(json_body);
+    response.content_length(response.body().size());
     response.set(http::field::cache_control, "no-cache"); 
     response.set(http::field::content_type, ContentType::APP_JSON);
     return response;
@@ -102,31 +102,37 @@ StringResponse ApiHandler::AddPlayer(std::string_view body) {
     return response;
 }
 
-StringResponse ApiHandler::GetPlayers(const Token& token, std::string_view body) {
+StringResponse ApiHandler::GetPlayers(const Token& token, const StringRequest& request) {
     StringResponse response;
     response.result(http::status::ok);
-    std::string string_body;
+    const auto encoding = GetResponseEncoding(request);
     auto player = app_.FindPlayer(token);
-    string_body = app_.ListPlayers(*player);
-    response.body() = string_body;
-    response.content_length(string_body.size());
-    response.set(http::field::cache_control, "no-cache"); 
-    response.set(http::field::content_type, ContentType::APP_JSON);
+    app_.ListPlayers(*player, response.body(), encoding);
+    SetStateHeaders(response, encoding);
     return response;
 }
 
-StringResponse ApiHandler::GetGameState(const Token& token, std::string_view body) {
+StringResponse ApiHandler::GetGameState(const Token& token, const StringRequest& request) {
     StringResponse response;
     response.result(http::status::ok);
-    std::string string_body;
-    string_body = app_.GetGameState(token);
-    response.body() = string_body;
-    response.content_length(string_body.size());
-    response.set(http::field::cache_control, "no-cache"); 
-    response.set(http::field::content_type, ContentType::APP_JSON);
+    const auto encoding = GetResponseEncoding(request);
+    app_.GetGameState(token, response.body(), encoding);
+    SetStateHeaders(response, encoding);
     return response;
 }
 
+app::ResponseEncoding ApiHandler::GetResponseEncoding(const StringRequest& request) const {
+    return app::SelectResponseEncoding(request[http::field::accept]);
+}
+
+void ApiHandler::SetStateHeaders(StringResponse& response, app::ResponseEncoding encoding) const {
+    response.content_length(response.body().size());
+    response.set(http::field::cache_control, "no-cache"); 
+    response.set(http::field::vary, "Accept");
+    response.set(http::field::content_type,
+                 encoding == app::ResponseEncoding::BINARY ? ContentType::APP_OCTET_STREAM : ContentType::APP_JSON);
+}
+
 StringResponse ApiHandler::UpdateGameState(std::string_view body) {
     StringResponse response;
     response.result(http::status::ok);
@@ -138,10 +144,19 @@ StringResponse ApiHandler::UpdateGameState(std::string_view body) {
         is_parsed = true;
     } catch (...) {
         
+    }
+    // необязательный maxStep ограничивает длину одного шага симуляции
+    std::chrono::milliseconds max_step(constants::DEFAULT_MAX_TICK_STEP);
+    if (is_parsed && json_body.is_object() && json_body.as_object().contains("maxStep")) {
+        const auto& max_step_json = json_body.at("maxStep");
+        is_parsed = max_step_json.is_int64() && max_step_json.as_int64() > 0;
+        if (is_parsed) {
+            max_step = std::chrono::milliseconds(max_step_json.as_int64());
+        }
     }
     if (is_parsed && json_body.as_object().contains("timeDelta") && json_body.at("timeDelta").is_int64() && json_body.at("timeDelta").as_int64() > 0) {
         std::chrono::milliseconds delta(json_body.at("timeDelta").as_int64());
-        app_.UpdateGame(delta);
+        app_.AdvanceGame(delta, max_step);
         string_body = "{}";
     } else {
         response.result(http::status::bad_request);
@@ -207,8 +222,8 @@ void ApiHandler::LinkPlayerList() {
         ptr->SetNeedAuthorisation(true)
             // .SetAllowedMethods({http::verb::post}, ErrorMessage::POST_IS_EXPECTED, MiscMessage::ALLOWED_POST_METHOD)
             .SetAllowedMethods({http::verb::get, http::verb::head}, ErrorMessage::GET_IS_EXPECTED, MiscMessage::ALLOWED_GET_HEAD_METHOD)
-            .SetProcessFunction([&](const Token& token, std::string_view body){
-                return GetPlayers(token, body);
+            .SetProcessFunction([&](const Token& token, const StringRequest& request){
+                return GetPlayers(token, request);
             });
     }
 }
@@ -219,8 +234,8 @@ void ApiHandler::LinkGameState() {
         ptr->SetNeedAuthorisation(true)
             // .SetAllowedMethods({http::verb::post}, ErrorMessage::POST_IS_EXPECTED, MiscMessage::ALLOWED_POST_METHOD)
             .SetAllowedMethods({http::verb::get, http::verb::head}, ErrorMessage::GET_IS_EXPECTED, MiscMessage::ALLOWED_GET_HEAD_METHOD)
-            .SetProcessFunction([&](const Token& token, std::string_view body){
-                return GetGameState(token, body);
+            .SetProcessFunction([&](const Token& token, const StringRequest& request){
+                return GetGameState(token, request);
             });
     }
 }
@@ -13,6 +13,7 @@ Application::Application(const std::filesystem::path& json_path, int tick_delta,
     , game_state_use_case_(game_, player_tokens_)
     , set_player_action_use_case_(player_tokens_)
     , update_game_use_case_(game_) 
+    , retire_players_use_case_(game_, players_, player_tokens_)
 {
     if (tick_delta) {
         ticker_ = std::make_shared<Ticker>(strand_, std::chrono::milliseconds(tick_delta), [this](std::chrono::milliseconds ms){
@@ -26,46 +27,29 @@ const Map* Application::FindMap(MapId id) {
     return get_map_use_case_.GetMap(id);
 }
 
-ListMapsUseCase::Maps Application::ListMaps() {
+const ListMapsUseCase::Maps& Application::ListMaps() {
     return list_maps_use_case_.ListMaps();
 }
 
-std::string Application::ListPlayers(const Player& player) {
-    return list_players_use_case_.GetPlayersList(player);
+void Application::ListPlayers(const Player& player, std::string& out, ResponseEncoding encoding) {
+    if (encoding == ResponseEncoding::BINARY) {
+        list_players_use_case_.GetPlayersListBinary(player, out);
+    } else {
+        list_players_use_case_.GetPlayersList(player, out);
+    }
 }
 
-std::string Application::GetGameState(const Token& token) {
+void Application::GetGameState(const Token& token, std::string& out, ResponseEncoding encoding) {
     auto game_state = game_state_use_case_.GetState(token);
-    json::object json_body;
-    for (const auto& player_state : game_state.players_states) {
-        json::array loot_json;
-        for (const auto& loot : player_state.bag) {
-            loot_json.push_back({{"id", loot.first}, {"type", loot.second}});
-        }
-        json_body.emplace(
-            std::to_string(*player_state.id)
-            , json::value{
-                {"pos", json::value{player_state.position.x, player_state.position.y}},
-                {"speed", json::value{player_state.speed.vx, player_state.speed.vy}},
-                {"dir", player_state.direction},
-                {"bag", loot_json}
-            }
-        );
+    profiling::ScopedPhase phase(profiling::TickPhase::SERIALIZATION);
+    if (encoding == ResponseEncoding::BINARY) {
+        // размер двоичного ответа известен заранее, подсказка не нужна
+        SerializeGameStateBinary(game_state, out);
+        return;
     }
-    json::object result;
-    result["players"] = json_body;
-    json_body.clear();
-    for (const auto& loot_state : game_state.loot_states) {
-        json_body.emplace(
-            std::to_string(loot_state.id)
-            , json::value{
-                {"type", loot_state.type},
-                {"pos", {loot_state.position.x, loot_state.position.y}}
-            }
-        );
-    }
-    result["lostObjects"] = json_body;
-    return json::serialize(result);
+    out.reserve(game_state_size_hint_);
+    SerializeGameState(game_state, out);
+    game_state_size_hint_ = out.size();
 }
 
 Application::Strand& Application::GetApiStrand() {
@@ -79,34 +63,68 @@ std::string Application::MovePlayer(const Token& token,const std::string& move)
 
 void Application::UpdateGame(const std::chrono::milliseconds& delta) {
     update_game_use_case_.Update(delta);
+    retire_players_use_case_.Retire(update_game_use_case_.TakeRetiredDogs());
+}
+
+void Application::AdvanceGame(std::chrono::milliseconds delta, std::chrono::milliseconds max_step) {
+    update_game_use_case_.Advance(delta, max_step);
+    retire_players_use_case_.Retire(update_game_use_case_.TakeRetiredDogs());
 }
 
+std::string Application::GetMetrics() {
+    std::string result;
+    metrics::Registry::Instance().Format(result);
 
-std::string Application::GetMapInfo(const Map& map) {
-    auto loot_types = GetLootTypes(map.GetLootTypes());
-    json::value result({
-        {"id", *map.GetId()},
-        {"name", map.GetName()},
-        // {"roads", ParseRoads(map.GetRoads())},
-        {"roads", ParseRoads(map.roads_for_test_)}, // TODO delete after tests;
-        {"buildings", ParseBuildings(map.GetBuildings())},
-        {"offices", ParseOffices(map.GetOffices())},
-        {"lootTypes", loot_types},
-    });
-    return json::serialize(result);
-}
-
-std::string Application::GetMapsSpec() {
-    auto maps = ListMaps();
-    json::array maps_json;
-    for (auto& map : maps){
-        maps_json.emplace_back(json::value({
-            {"id", map.id},
-            {"name", map.name},
-            {"lootTypes", GetLootTypes(map.loot_types)}
-        }));
+    auto& sessions = game_.GetSessions();
+    metrics::AppendHelp(result, "game_server_sessions"sv, "gauge"sv, "Active game sessions."sv);
+    metrics::AppendSample(result, "game_server_sessions"sv, {}, double(sessions.size()));
+    metrics::AppendHelp(result, "game_server_session_dogs"sv, "gauge"sv, "Dogs in game session."sv);
+    for (auto& session : sessions) {
+        metrics::AppendSample(result, "game_server_session_dogs"sv, MakeSessionLabels(session),
+                              double(session.GetDogs().size()));
+    }
+    metrics::AppendHelp(result, "game_server_session_loot"sv, "gauge"sv, "Lost objects in game session."sv);
+    for (auto& session : sessions) {
+        metrics::AppendSample(result, "game_server_session_loot"sv, MakeSessionLabels(session),
+                              double(session.GetLoot().size()));
     }
-    return json::serialize(maps_json);
+    return result;
+}
+
+std::string Application::GetTickTrace() {
+    return profiling::TickProfiler::Instance().DumpChromeTrace();
+}
+
+std::string Application::MakeSessionLabels(model::GameSession& session) const {
+    return "map=\""s + *session.GetMapId() + "\",session=\""s + std::to_string(session.GetId()) + "\""s;
+}
+
+
+void Application::GetMapInfo(const Map& map, std::string& out) {
+    json_writer::JsonWriter writer(out);
+    writer.BeginObject();
+    writer.Key("id").String(*map.GetId());
+    writer.Key("name").String(map.GetName());
+    writer.Key("roads");
+    WriteRoads(writer, map.roads_for_test_); // TODO delete after tests;
+    writer.Key("buildings");
+    WriteBuildings(writer, map.GetBuildings());
+    writer.Key("offices");
+    WriteOffices(writer, map.GetOffices());
+    writer.Key("lootTypes");
+    WriteLootTypes(writer, map.GetLootTypes());
+    writer.EndObject();
+}
+
+void Application::GetMapsSpec(std::string& out) {
+    json_writer::JsonWriter writer(out);
+    writer.BeginArray();
+    for (const auto& map : ListMaps()) {
+        writer.BeginObject().Key("id").String(map.id).Key("name").String(map.name).Key("lootTypes");
+        WriteLootTypes(writer, map.loot_types);
+        writer.EndObject();
+    }
+    writer.EndArray();
 }
 
 JoinGameResult Application::JoinGame(std::string map_id, std::string name) {
@@ -147,71 +165,71 @@ json::array Application::ParseRoads(const model::Roads& roads) const{
 }
 
 // TODO delete after all tests passed
-json::array Application::ParseRoads(const std::vector<Road>& roads) const{
-    json::array result;
-    for (auto&& road : roads){
-        json::object j;
-        auto start = road.GetStart();
-        auto end = road.GetEnd();
-        j.emplace("x0", start.x);
+void Application::WriteRoads(json_writer::JsonWriter& writer, const std::vector<Road>& roads) const {
+    writer.BeginArray();
+    for (const auto& road : roads) {
+        const auto start = road.GetStart();
+        const auto end = road.GetEnd();
+        writer.BeginObject();
+        writer.Key("x0").Int(start.x);
         if (road.IsHorizontal()) {
-            j.emplace("x1", end.x);
+            writer.Key("x1").Int(end.x);
         }
-        j.emplace("y0", start.y);
+        writer.Key("y0").Int(start.y);
         if (road.IsVertical()) {
-            j.emplace("y1", end.y);
+            writer.Key("y1").Int(end.y);
         }
-        result.push_back(j);
+        writer.EndObject();
     }
-    return result;
+    writer.EndArray();
 }
 
-json::array Application::ParseBuildings(const std::vector<Building>& buildings) const{
-    json::array result;
-    for (auto&& building : buildings){
-        json::object j;
-        auto bounds = building.GetBounds();
-        j.emplace("x", bounds.position.x);
-        j.emplace("y", bounds.position.y);
-        j.emplace("w", bounds.size.width);
-        j.emplace("h", bounds.size.height);
-        result.push_back(j);
+void Application::WriteBuildings(json_writer::JsonWriter& writer, const std::vector<Building>& buildings) const {
+    writer.BeginArray();
+    for (const auto& building : buildings) {
+        const auto& bounds = building.GetBounds();
+        writer.BeginObject();
+        writer.Key("x").Int(bounds.position.x).Key("y").Int(bounds.position.y);
+        writer.Key("w").Int(bounds.size.width).Key("h").Int(bounds.size.height);
+        writer.EndObject();
     }
-    return result;
-}
-
-json::array Application::ParseOffices(const std::vector<Office>& offices) const{
-    json::array result;
-    for (auto&& office : offices){
-        json::object j;
-        auto pos = office.GetPosition();
-        auto offset = office.GetOffset();
-        j.emplace("id", *office.GetId());
-        j.emplace("x", pos.x);
-        j.emplace("y", pos.y);
-        j.emplace("offsetX", offset.dx);
-        j.emplace("offsetY", offset.dy);
-        result.push_back(j);
+    writer.EndArray();
+}
+
+void Application::WriteOffices(json_writer::JsonWriter& writer, const std::vector<Office>& offices) const {
+    writer.BeginArray();
+    for (const auto& office : offices) {
+        const auto pos = office.GetPosition();
+        const auto offset = office.GetOffset();
+        writer.BeginObject();
+        writer.Key("id").String(*office.GetId());
+        writer.Key("x").Int(pos.x).Key("y").Int(pos.y);
+        writer.Key("offsetX").Int(offset.dx).Key("offsetY").Int(offset.dy);
+        writer.EndObject();
     }
-    return result;
-}
-
-json::array Application::GetLootTypes(model::Map::LootTypes loot_types) {
-    json::array loot_types_json;
-    for(auto& loot_type: loot_types) {
-        json::object parameters;
-        for (const auto& param : loot_type.parameters) {
-            if (param.first == "rotation") {
-                parameters[param.first] = std::stoi(param.second);
-            } else if (param.first == "scale") {
-                parameters[param.first] = std::stod(param.second);
-            } else {
-                parameters[param.first] = param.second;
-            }
+    writer.EndArray();
+}
+
+void Application::WriteLootTypes(json_writer::JsonWriter& writer, const model::Map::LootTypes& loot_types) const {
+    writer.BeginArray();
+    for (const auto& loot_type : loot_types) {
+        writer.BeginObject();
+        writer.Key("name").String(loot_type.name);
+        writer.Key("file").String(loot_type.file);
+        writer.Key("type").String(loot_type.type);
+        if (loot_type.rotation) {
+            writer.Key("rotation").Int(*loot_type.rotation);
+        }
+        if (loot_type.color) {
+            writer.Key("color").String(*loot_type.color);
+        }
+        if (loot_type.scale) {
+            writer.Key("scale").Double(*loot_type.scale);
         }
-        loot_types_json.emplace_back(parameters);
+        writer.Key("value").Int(loot_type.value);
+        writer.EndObject();
     }
-    return loot_types_json;
+    writer.EndArray();
 }
 
 
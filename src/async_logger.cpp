@@ -0,0 +1,268 @@
+#include "async_logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+namespace server_logging {
+
+using namespace std::literals;
+
+namespace {
+
+void AppendEscaped(std::string& out, std::string_view str) {
+    for (char ch : str) {
+        switch (ch) {
+            case '"': out += "\\\""sv; break;
+            case '\\': out += "\\\\"sv; break;
+            case '\n': out += "\\n"sv; break;
+            case '\r': out += "\\r"sv; break;
+            case '\t': out += "\\t"sv; break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", ch);
+                    out += buffer;
+                } else {
+                    out.push_back(ch);
+                }
+        }
+    }
+}
+
+std::string FormatAddress(const LogRecord& record) {
+    if (record.is_v4) {
+        net::ip::address_v4::bytes_type bytes;
+        std::copy_n(record.address.begin(), bytes.size(), bytes.begin());
+        return net::ip::address_v4(bytes).to_string();
+    }
+    return net::ip::address_v6(record.address).to_string();
+}
+
+std::int64_t NowMicroseconds() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+void LogRecord::SetAddress(const net::ip::address& addr) {
+    is_v4 = addr.is_v4();
+    if (is_v4) {
+        auto bytes = addr.to_v4().to_bytes();
+        std::copy(bytes.begin(), bytes.end(), address.begin());
+    } else {
+        address = addr.to_v6().to_bytes();
+    }
+}
+
+void LogRecord::SetText(std::string_view str) {
+    text_size = std::uint16_t(std::min(str.size(), MAX_TEXT_SIZE));
+    std::copy_n(str.data(), text_size, text.begin());
+}
+
+bool AsyncLogger::Ring::TryPush(const LogRecord& record) noexcept {
+    const auto head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == RING_CAPACITY) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    records_[head & MASK] = record;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool AsyncLogger::Ring::TryPop(LogRecord& record) noexcept {
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    record = records_[tail & MASK];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+AsyncLogger& AsyncLogger::Instance() {
+    static AsyncLogger logger;
+    return logger;
+}
+
+AsyncLogger::~AsyncLogger() {
+    Stop();
+}
+
+void AsyncLogger::Start(std::ostream& output) {
+    if (running_.exchange(true)) {
+        return;
+    }
+    output_ = &output;
+    worker_ = std::thread([this] {
+        Run();
+    });
+}
+
+void AsyncLogger::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void AsyncLogger::LogRequest(const net::ip::address& address, std::string_view uri, http::verb method) {
+    if (!IsRunning()) {
+        return;
+    }
+    LogRecord record{LogRecord::Type::REQUEST};
+    record.SetAddress(address);
+    record.SetText(uri);
+    record.method = method;
+    Push(record);
+}
+
+void AsyncLogger::LogResponse(const net::ip::address& address, std::chrono::nanoseconds duration, unsigned code,
+                              std::string_view content_type) {
+    if (!IsRunning()) {
+        return;
+    }
+    LogRecord record{LogRecord::Type::RESPONSE};
+    record.SetAddress(address);
+    record.SetText(content_type);
+    record.duration_ns = duration.count();
+    record.code = code;
+    Push(record);
+}
+
+void AsyncLogger::LogConnectionClosed() {
+    if (!IsRunning()) {
+        return;
+    }
+    LogRecord record{LogRecord::Type::CONNECTION_CLOSED};
+    Push(record);
+}
+
+void AsyncLogger::Push(LogRecord& record) {
+    record.timestamp_us = NowMicroseconds();
+    GetThreadRing().TryPush(record);
+}
+
+AsyncLogger::Ring& AsyncLogger::GetThreadRing() {
+    thread_local std::shared_ptr<Ring> ring = [this] {
+        auto new_ring = std::make_shared<Ring>();
+        std::lock_guard lock(rings_mutex_);
+        rings_.push_back(new_ring);
+        return new_ring;
+    }();
+    return *ring;
+}
+
+void AsyncLogger::Run() {
+    std::string batch;
+    auto last_drop_report = std::chrono::steady_clock::now();
+    std::uint64_t dropped = 0;
+    while (true) {
+        const bool stopping = !IsRunning();
+        batch.clear();
+        const size_t drained = Drain(batch);
+
+        {
+            std::lock_guard lock(rings_mutex_);
+            for (auto& ring : rings_) {
+                dropped += ring->TakeDropped();
+            }
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (dropped > 0 && (stopping || now - last_drop_report >= 1s)) {
+            dropped_total_.fetch_add(dropped, std::memory_order_relaxed);
+            FormatTimestamp(NowMicroseconds(), batch);
+            batch += R"(,"data":{"dropped":)"sv;
+            batch += std::to_string(dropped);
+            batch += R"(},"message":"log records dropped"})"sv;
+            batch.push_back('\n');
+            dropped = 0;
+            last_drop_report = now;
+        }
+
+        if (!batch.empty()) {
+            output_->write(batch.data(), std::streamsize(batch.size()));
+            output_->flush();
+        }
+        if (stopping && drained == 0) {
+            break;
+        }
+        if (drained == 0) {
+            std::this_thread::sleep_for(FLUSH_PERIOD);
+        }
+    }
+}
+
+size_t AsyncLogger::Drain(std::string& batch) {
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard lock(rings_mutex_);
+        rings = rings_;
+    }
+    size_t drained = 0;
+    LogRecord record;
+    for (auto& ring : rings) {
+        // не больше одного буфера за проход, чтобы один поток не задерживал вывод остальных
+        for (size_t i = 0; i < RING_CAPACITY && ring->TryPop(record); ++i) {
+            Format(record, batch);
+            ++drained;
+        }
+    }
+    return drained;
+}
+
+void AsyncLogger::FormatTimestamp(std::int64_t timestamp_us, std::string& out) {
+    const std::int64_t second = timestamp_us / 1000000;
+    if (second != cached_second_) {
+        std::time_t time = std::time_t(second);
+        std::tm tm{};
+        localtime_r(&time, &tm);
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%FT%T", &tm);
+        cached_date_ = buffer;
+        cached_second_ = second;
+    }
+    char micros[8];
+    std::snprintf(micros, sizeof(micros), ".%06d", int(timestamp_us % 1000000));
+    out += R"({"timestamp":")"sv;
+    out += cached_date_;
+    out += micros;
+    out.push_back('"');
+}
+
+void AsyncLogger::Format(const LogRecord& record, std::string& out) {
+    const std::string_view text{record.text.data(), record.text_size};
+    FormatTimestamp(record.timestamp_us, out);
+    switch (record.type) {
+        case LogRecord::Type::REQUEST:
+            out += R"(,"data":{"ip":")"sv;
+            out += FormatAddress(record);
+            out += R"(","URI":")"sv;
+            AppendEscaped(out, text);
+            out += R"(","method":")"sv;
+            out += http::to_string(record.method);
+            out += R"("},"message":"request received"})"sv;
+            break;
+        case LogRecord::Type::RESPONSE:
+            out += R"(,"data":{"ip":")"sv;
+            out += FormatAddress(record);
+            out += R"(","response_time":)"sv;
+            out += std::to_string(record.duration_ns / 100000);
+            out += R"(,"code":)"sv;
+            out += std::to_string(record.code);
+            out += R"(,"content_type":")"sv;
+            AppendEscaped(out, text);
+            out += R"("},"message":"response sent"})"sv;
+            break;
+        case LogRecord::Type::CONNECTION_CLOSED:
+            out += R"(,"data":{"code":0},"message":"server exited"})"sv;
+            break;
+    }
+    out.push_back('\n');
+}
+
+}  // namespace server_logging
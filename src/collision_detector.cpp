@@ -25,10 +25,16 @@ CollectionResult TryCollectPoint(geom::Point2D a, geom::Point2D b, geom::Point2D
 // она будет линковаться извне.
 
 std::vector<GatheringEvent> FindGatherEvents(const ItemGathererProvider& provider) {
+    std::vector<GatheringEvent> gathering_events;
+    FindGatherEvents(provider, gathering_events);
+    return gathering_events;
+}
+
+void FindGatherEvents(const ItemGathererProvider& provider, std::vector<GatheringEvent>& gathering_events) {
+    gathering_events.clear();
     if (provider.ItemsCount() == 0 || provider.GatherersCount() == 0) {
-        return {};
+        return;
     }
-    std::vector<GatheringEvent> gathering_events;
     for (size_t gatherer_idx = 0; gatherer_idx < provider.GatherersCount(); ++gatherer_idx) {
         auto gatherer = provider.GetGatherer(gatherer_idx);
         if (gatherer.start_pos == gatherer.end_pos) {
@@ -53,8 +59,6 @@ std::vector<GatheringEvent> FindGatherEvents(const ItemGathererProvider& provide
               [](const GatheringEvent& e_l, const GatheringEvent& e_r) {
                   return e_l.time < e_r.time;
               });
-
-    return gathering_events;
 }
 
 }  // namespace collision_detector
\ No newline at end of file
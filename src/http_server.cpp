@@ -1,5 +1,9 @@
 #include "http_server.h"
 
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
 namespace http_server {
     
 void ReportError(beast::error_code ec, std::string_view errmsg){
@@ -14,4 +18,55 @@ void ReportError(beast::error_code ec, std::string_view errmsg){
                   beast::bind_front_handler(&SessionBase::Read, GetSharedThis()));
     }
 
+void SessionBase::Write(http_handler::SendfileResponse&& response) {
+#ifdef __linux__
+    auto safe_response = std::make_shared<http_handler::SendfileResponse>(std::move(response));
+    auto serializer = std::make_shared<http::response_serializer<http_handler::SendfileBody>>(*safe_response);
+    auto self = GetSharedThis();
+    http::async_write_header(stream_, *serializer,
+                             [safe_response, serializer, self](beast::error_code ec, std::size_t bytes_written) {
+                                 if (ec) {
+                                     return self->OnWrite(true, ec, bytes_written);
+                                 }
+                                 self->SendFile(safe_response, 0);
+                             });
+#else
+    Write<http_handler::SendfileBody, http::fields>(std::move(response));
+#endif
+}
+
+void SessionBase::SendFile(std::shared_ptr<http_handler::SendfileResponse> response, std::uint64_t offset) {
+#ifdef __linux__
+    // offset - сколько байт тела уже отправлено
+    auto& socket = stream_.socket();
+    beast::error_code ec;
+    socket.native_non_blocking(true, ec);
+    const auto& body = response->body();
+    const int file_fd = body.file.native_handle();
+    const std::uint64_t size = body.size;
+    while (!ec && offset < size) {
+        off_t file_offset = off_t(body.offset + offset);
+        const ssize_t sent = ::sendfile(socket.native_handle(), file_fd, &file_offset, size_t(size - offset));
+        if (sent > 0) {
+            offset += std::uint64_t(sent);
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Буфер сокета заполнен - ждём, пока он освободится, и продолжаем с того же места
+            socket.async_wait(tcp::socket::wait_write, [response, offset, self = GetSharedThis()](beast::error_code ec) {
+                if (ec) {
+                    return self->OnWrite(true, ec, offset);
+                }
+                self->SendFile(response, offset);
+            });
+            return;
+        } else {
+            ec = sent < 0 ? beast::error_code(errno, boost::system::system_category())
+                          : beast::error_code(net::error::eof);
+        }
+    }
+    OnWrite(response->need_eof() || ec, ec, offset);
+#endif
+}
+
 }  // namespace http_server
@@ -2,18 +2,30 @@
 
 namespace {
 
-model::LootType ConvertJsonToLootType(boost::json::value loot_json) {
+double JsonToDouble(const boost::json::value& value) {
+    if (value.is_int64()) {
+        return double(value.as_int64());
+    }
+    return value.as_double();
+}
+
+model::LootType ConvertJsonToLootType(const boost::json::value& loot_json) {
+    const auto& loot_object = loot_json.as_object();
     model::LootType loot;
-    for (const auto& param : loot_json.as_object()) {
-        std::string value;
-        if (param.value().is_int64()) {
-            value = std::to_string(param.value().as_int64());
-        } else if (param.value().is_double()) {
-            value = std::to_string(param.value().as_double());
-        } else {
-            value = param.value().as_string();
-        }
-        loot.parameters.emplace(param.key(), value);     
+    loot.name = loot_object.at("name").as_string().c_str();
+    loot.file = loot_object.at("file").as_string().c_str();
+    loot.type = loot_object.at("type").as_string().c_str();
+    if (auto rotation = loot_object.if_contains("rotation")) {
+        loot.rotation = int(JsonToDouble(*rotation));
+    }
+    if (auto color = loot_object.if_contains("color")) {
+        loot.color = color->as_string().c_str();
+    }
+    if (auto scale = loot_object.if_contains("scale")) {
+        loot.scale = JsonToDouble(*scale);
+    }
+    if (auto value = loot_object.if_contains("value")) {
+        loot.value = int(JsonToDouble(*value));
     }
     return loot;
 }
@@ -34,6 +46,9 @@ model::Game LoadGame(const std::filesystem::path& json_path) {
     auto loot_gen_properties = GetLootGenProp(configJSON);
     game.SetLootGenPeriod(loot_gen_properties.perion);
     game.SetLootGenProbability(loot_gen_properties.probability);
+    game.SetMaxPlayersPerSession(GetMaxPlayersPerSession(configJSON));
+    game.SetDogRetirementTime(GetDogRetirementTime(configJSON));
+    game.SetFixedPointCoordinates(GetFixedPointCoordinates(configJSON));
     for (auto&& json_map : configJSON.at("maps").as_array()) {
         game.AddMap(LoadMap(json_map, default_dog_speed, default_bag_capacity)); 
     }
@@ -72,6 +87,30 @@ int GetDefaultBagCapacity(const json::value& config) {
     return default_bag_capacity;
 }
 
+int GetMaxPlayersPerSession(const json::value& config) {
+    int max_players = constants::DEFAULT_MAX_PLAYERS_PER_SESSION;
+    if (config.as_object().contains("maxPlayersPerSession")) {
+        max_players = int(config.at("maxPlayersPerSession").as_int64());
+    }
+    return max_players;
+}
+
+int GetDogRetirementTime(const json::value& config) {
+    int retirement_time = constants::DEFAULT_DOG_RETIREMENT_TIME;
+    if (config.as_object().contains("dogRetirementTime")) {
+        retirement_time = int(JsonToDouble(config.at("dogRetirementTime")) * 1000); // s -> ms
+    }
+    return retirement_time;
+}
+
+bool GetFixedPointCoordinates(const json::value& config) {
+    bool is_fixed_point = constants::DEFAULT_FIXED_POINT_COORDINATES;
+    if (config.as_object().contains("fixedPointCoordinates")) {
+        is_fixed_point = config.at("fixedPointCoordinates").as_bool();
+    }
+    return is_fixed_point;
+}
+
 model::Map LoadMap(const json::value& json_map, model::Speed default_dog_speed, int default_bag_capacity) {
     util::Tagged<std::string, model::Map> id{json_map.at("id").as_string().c_str()};
     model::Map map(id, json_map.at("name").as_string().c_str());
@@ -0,0 +1,147 @@
+#include "json_writer.h"
+
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace json_writer {
+
+JsonWriter& JsonWriter::BeginObject() {
+    Open('{');
+    return *this;
+}
+
+JsonWriter& JsonWriter::EndObject() {
+    Close('}');
+    return *this;
+}
+
+JsonWriter& JsonWriter::BeginArray() {
+    Open('[');
+    return *this;
+}
+
+JsonWriter& JsonWriter::EndArray() {
+    Close(']');
+    return *this;
+}
+
+JsonWriter& JsonWriter::Key(std::string_view key) {
+    BeforeValue();
+    WriteString(key);
+    out_ += ':';
+    after_key_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::Key(std::uint64_t key) {
+    BeforeValue();
+    char buffer[24];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), key);
+    out_ += '"';
+    out_.append(buffer, result.ptr);
+    out_ += "\":";
+    after_key_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::String(std::string_view value) {
+    BeforeValue();
+    WriteString(value);
+    return *this;
+}
+
+JsonWriter& JsonWriter::Int(std::int64_t value) {
+    BeforeValue();
+    char buffer[24];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out_.append(buffer, result.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::Double(double value) {
+    BeforeValue();
+    if (!std::isfinite(value)) {
+        out_ += "null";
+        return *this;
+    }
+    // кратчайшая запись, которая читается обратно в то же число
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out_.append(buffer, result.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::Bool(bool value) {
+    BeforeValue();
+    out_ += value ? "true" : "false";
+    return *this;
+}
+
+JsonWriter& JsonWriter::Null() {
+    BeforeValue();
+    out_ += "null";
+    return *this;
+}
+
+void JsonWriter::BeforeValue() {
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (depth_ > 0) {
+        if (has_items_[depth_ - 1]) {
+            out_ += ',';
+        }
+        has_items_[depth_ - 1] = true;
+    }
+}
+
+void JsonWriter::Open(char bracket) {
+    if (depth_ == MAX_DEPTH) {
+        throw std::length_error("JSON nesting is too deep");
+    }
+    BeforeValue();
+    out_ += bracket;
+    has_items_[depth_++] = false;
+}
+
+void JsonWriter::Close(char bracket) {
+    if (depth_ == 0) {
+        throw std::logic_error("Unbalanced JSON brackets");
+    }
+    --depth_;
+    out_ += bracket;
+}
+
+void JsonWriter::WriteString(std::string_view value) {
+    constexpr std::string_view HEX = "0123456789abcdef";
+    out_ += '"';
+    size_t plain_start = 0;
+    for (size_t i = 0; i < value.size(); ++i) {
+        const auto c = static_cast<unsigned char>(value[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        // обычные символы копируются кусками, экранируются только кавычки, \ и управляющие
+        out_.append(value.data() + plain_start, i - plain_start);
+        plain_start = i + 1;
+        switch (c) {
+            case '"': out_ += "\\\""; break;
+            case '\\': out_ += "\\\\"; break;
+            case '\n': out_ += "\\n"; break;
+            case '\r': out_ += "\\r"; break;
+            case '\t': out_ += "\\t"; break;
+            case '\b': out_ += "\\b"; break;
+            case '\f': out_ += "\\f"; break;
+            default:
+                out_ += "\\u00";
+                out_ += HEX[c >> 4];
+                out_ += HEX[c & 0xF];
+        }
+    }
+    out_.append(value.data() + plain_start, value.size() - plain_start);
+    out_ += '"';
+}
+
+}  // namespace json_writer
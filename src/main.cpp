@@ -12,6 +12,7 @@
 #include "request_handler.h"
 #include "logging_request_handler.h"
 #include "application.h"
+#include "tick_profiler.h"
 
 using namespace std::literals;
 namespace net = boost::asio;    
@@ -22,6 +23,10 @@ struct Args {
     std::string config;
     int tick_delta = 0;
     bool is_player_pos_random = false;
+    std::string log_level = "info";
+    std::vector<std::string> log_sample_rates;
+    int log_slow_ms = int(server_logging::AccessLogPolicy::DEFAULT_SLOW_THRESHOLD.count());
+    bool profile_ticks = false;
 }; 
 
 [[nodiscard]] std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
@@ -34,7 +39,12 @@ struct Args {
         ("www-root,w", po::value(&args.static_dir)->value_name("dir"s), "Set static files root")  //
         ("config-file,c", po::value(&args.config)->value_name("file"s), "Set config file path") //
         ("tick-period,t", po::value(&args.tick_delta)->value_name("milliseconds"s), "Set tick period") //
-        ("randomize-spawn-points,rnd", "Spawn dogs at random positions");
+        ("randomize-spawn-points,rnd", "Spawn dogs at random positions") //
+        ("log-level", po::value(&args.log_level)->value_name("level"s), "Set minimal access log level: trace, debug, info, warning, error") //
+        ("log-sample", po::value(&args.log_sample_rates)->multitoken()->value_name("route=rate"s), 
+            "Set access log sampling rate for URI prefix or 'static', e.g. /api/v1/game/state=0.01") //
+        ("log-slow-ms", po::value(&args.log_slow_ms)->value_name("milliseconds"s), "Always log responses slower than this") //
+        ("profile-ticks", "Record tick phase timings, available as Chrome trace at /admin/tick-trace");
 
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -57,6 +67,10 @@ struct Args {
         args.is_player_pos_random = true;
     }
 
+    if (vm.contains("profile-ticks"s)) {
+        args.profile_ticks = true;
+    }
+
     if (vm.contains("tick-period"s)) {
         if (args.tick_delta < 0) {
             args.tick_delta = 0;
@@ -66,6 +80,18 @@ struct Args {
     return args;
 } 
 
+server_logging::AccessLogPolicy MakeAccessLogPolicy(const Args& args) {
+    using server_logging::AccessLogPolicy;
+    std::vector<AccessLogPolicy::SampleRate> sample_rates;
+    for (const auto& sample_rate : args.log_sample_rates) {
+        sample_rates.push_back(AccessLogPolicy::ParseSampleRate(sample_rate));
+    }
+    return AccessLogPolicy(
+        AccessLogPolicy::ParseLevel(args.log_level), 
+        std::move(sample_rates), 
+        std::chrono::milliseconds(args.log_slow_ms));
+}
+
 namespace {
 
 // Запускает функцию fn на n потоках, включая текущий
@@ -95,6 +121,8 @@ int main(int argc, const char* argv[]) {
         std::clog,
         keywords::format = &MyFormatter
     );
+    // журнал запросов пишется асинхронно, чтобы не форматировать JSON в потоках ввода-вывода
+    server_logging::AsyncLogger::Instance().Start(std::clog);
     try {
         if (auto args = ParseCommandLine(argc, argv)) {
             // инициируем логгер
@@ -102,6 +130,7 @@ int main(int argc, const char* argv[]) {
 
             // 1. Загружаем карту из файла и построить модель игры
             auto static_root_path = args.value().static_dir;
+            profiling::TickProfiler::SetEnabled(args.value().profile_ticks);
             // 2. Инициализируем io_context
             const unsigned num_threads = std::thread::hardware_concurrency();
             net::io_context ioc(num_threads);
@@ -124,7 +153,7 @@ int main(int argc, const char* argv[]) {
                 strand);
 
             auto handler = std::make_shared<RequestHandler>(*app, static_root_path);
-            server_logging::LoggingRequestHandler<std::shared_ptr<RequestHandler>> log_handler(handler);
+            server_logging::LoggingRequestHandler<std::shared_ptr<RequestHandler>> log_handler(handler, MakeAccessLogPolicy(*args));
 
             // 5. Запустить обработчик HTTP-запросов, делегируя их обработчику запросов
             auto address = net::ip::make_address("0.0.0.0");
@@ -149,6 +178,7 @@ int main(int argc, const char* argv[]) {
                 ioc.run();
             });    
         }
+        server_logging::AsyncLogger::Instance().Stop();
         return EXIT_SUCCESS;
     } catch (const std::exception& e) {
         std::cout << e.what() << std::endl;
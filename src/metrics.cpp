@@ -0,0 +1,255 @@
+#include "metrics.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+
+#include "constants.h"
+
+namespace metrics {
+
+namespace {
+
+constexpr std::uint64_t MICROSECONDS_PER_SECOND = 1000000;
+constexpr double MICROSECOND = 1.0 / MICROSECONDS_PER_SECOND;
+
+std::uint64_t ToMicroseconds(std::chrono::nanoseconds duration) noexcept {
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    return us > 0 ? std::uint64_t(us) : 0;
+}
+
+void AppendNumber(std::string& out, double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    out += buffer;
+}
+
+std::string MakeLabels(std::string_view labels, std::string_view extra) {
+    std::string result;
+    result.reserve(labels.size() + extra.size() + 3);
+    result += '{';
+    result += labels;
+    if (!labels.empty() && !extra.empty()) {
+        result += ',';
+    }
+    result += extra;
+    result += '}';
+    return result;
+}
+
+}  // namespace
+
+size_t Histogram::BucketIndex(std::uint64_t value) noexcept {
+    if (value < LINEAR_BUCKETS) {
+        return size_t(value);
+    }
+    const size_t power = size_t(std::bit_width(value)) - 1;  // >= 3
+    const size_t sub_bucket = size_t(value >> (power - 2)) & (SUB_BUCKETS - 1);
+    return LINEAR_BUCKETS + (power - 3) * SUB_BUCKETS + sub_bucket;
+}
+
+std::uint64_t Histogram::BucketUpperBound(size_t index) noexcept {
+    if (index < LINEAR_BUCKETS) {
+        return index;
+    }
+    const size_t power = (index - LINEAR_BUCKETS) / SUB_BUCKETS + 3;
+    const size_t sub_bucket = (index - LINEAR_BUCKETS) % SUB_BUCKETS;
+    const std::uint64_t width = std::uint64_t(1) << (power - 2);
+    return (SUB_BUCKETS + sub_bucket) * width + width - 1;
+}
+
+void Histogram::Record(std::uint64_t value) noexcept {
+    if (const size_t index = BucketIndex(value); index < BUCKET_COUNT) {
+        Increment(buckets_[index]);
+    }
+    Increment(count_);
+    Increment(sum_, value);
+}
+
+void Histogram::AddTo(Snapshot& snapshot) const noexcept {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        snapshot.buckets[i] += buckets_[i].load(std::memory_order_relaxed);
+    }
+    snapshot.count += count_.load(std::memory_order_relaxed);
+    snapshot.sum += sum_.load(std::memory_order_relaxed);
+}
+
+Endpoint ClassifyEndpoint(std::string_view target) noexcept {
+    using Uri = ::Endpoint;
+    target = target.substr(0, target.find('?'));
+    if (!target.starts_with(Uri::API)) {
+        return target == Uri::METRICS ? Endpoint::METRICS : Endpoint::STATIC;
+    }
+    if (target == Uri::GAME_STATE) return Endpoint::GAME_STATE;
+    if (target == Uri::PLAYER_ACTION) return Endpoint::PLAYER_ACTION;
+    if (target == Uri::PLAYER_LIST) return Endpoint::PLAYER_LIST;
+    if (target == Uri::JOIN_GAME) return Endpoint::JOIN_GAME;
+    if (target == Uri::GAME_TICK) return Endpoint::GAME_TICK;
+    // список карт запрашивается как /api/v1/maps, карта - как /api/v1/maps/{id}
+    if (target.starts_with(Uri::MAPS.substr(0, Uri::MAPS.size() - 1))) return Endpoint::MAPS;
+    return Endpoint::OTHER_API;
+}
+
+std::string_view GetEndpointName(Endpoint endpoint) noexcept {
+    switch (endpoint) {
+        case Endpoint::JOIN_GAME: return "join"sv;
+        case Endpoint::PLAYER_LIST: return "players"sv;
+        case Endpoint::GAME_STATE: return "state"sv;
+        case Endpoint::GAME_TICK: return "tick"sv;
+        case Endpoint::PLAYER_ACTION: return "action"sv;
+        case Endpoint::MAPS: return "maps"sv;
+        case Endpoint::METRICS: return "metrics"sv;
+        case Endpoint::OTHER_API: return "other_api"sv;
+        case Endpoint::STATIC: return "static"sv;
+        case Endpoint::COUNT: break;
+    }
+    return "unknown"sv;
+}
+
+Registry& Registry::Instance() {
+    static Registry registry;
+    return registry;
+}
+
+Registry::ThreadMetrics& Registry::Local() {
+    thread_local std::shared_ptr<ThreadMetrics> local = [this] {
+        auto thread_metrics = std::make_shared<ThreadMetrics>();
+        std::lock_guard lock(mutex_);
+        threads_.push_back(thread_metrics);
+        return thread_metrics;
+    }();
+    return *local;
+}
+
+void Registry::RecordRequest(Endpoint endpoint, unsigned code, std::chrono::nanoseconds duration) noexcept {
+    auto& local = Local();
+    const size_t status_class = std::min<size_t>(std::max(code / 100, 1u), STATUS_CLASSES) - 1;
+    auto& counter = local.requests[size_t(endpoint)][status_class];
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    local.request_durations[size_t(endpoint)].Record(ToMicroseconds(duration));
+}
+
+void Registry::RecordTick(std::chrono::nanoseconds duration, std::chrono::nanoseconds lag) noexcept {
+    auto& local = Local();
+    local.tick_durations.Record(ToMicroseconds(duration));
+    local.tick_lags.Record(ToMicroseconds(lag));
+}
+
+void Registry::RecordMissedTicks(std::uint64_t count) noexcept {
+    auto& counter = Local().ticks_missed;
+    counter.store(counter.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+}
+
+void Registry::ConnectionOpened() noexcept {
+    auto& counter = Local().connections_opened;
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void Registry::ConnectionClosed() noexcept {
+    auto& counter = Local().connections_closed;
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void Registry::Format(std::string& out) {
+    std::array<std::array<std::uint64_t, STATUS_CLASSES>, ENDPOINT_COUNT> requests{};
+    std::array<Histogram::Snapshot, ENDPOINT_COUNT> durations;
+    Histogram::Snapshot tick_durations;
+    Histogram::Snapshot tick_lags;
+    std::uint64_t ticks_missed = 0;
+    std::uint64_t opened = 0;
+    std::uint64_t closed = 0;
+    {
+        std::lock_guard lock(mutex_);
+        for (const auto& thread_metrics : threads_) {
+            for (size_t e = 0; e < ENDPOINT_COUNT; ++e) {
+                for (size_t c = 0; c < STATUS_CLASSES; ++c) {
+                    requests[e][c] += thread_metrics->requests[e][c].load(std::memory_order_relaxed);
+                }
+                thread_metrics->request_durations[e].AddTo(durations[e]);
+            }
+            thread_metrics->tick_durations.AddTo(tick_durations);
+            thread_metrics->tick_lags.AddTo(tick_lags);
+            ticks_missed += thread_metrics->ticks_missed.load(std::memory_order_relaxed);
+            opened += thread_metrics->connections_opened.load(std::memory_order_relaxed);
+            closed += thread_metrics->connections_closed.load(std::memory_order_relaxed);
+        }
+    }
+
+    AppendHelp(out, "game_server_http_requests_total"sv, "counter"sv, "Handled HTTP requests by endpoint and status class."sv);
+    for (size_t e = 0; e < ENDPOINT_COUNT; ++e) {
+        for (size_t c = 0; c < STATUS_CLASSES; ++c) {
+            if (requests[e][c] == 0) {
+                continue;
+            }
+            auto labels = "endpoint=\""s + std::string(GetEndpointName(Endpoint(e))) + "\",code=\""s
+                        + std::to_string(c + 1) + "xx\""s;
+            AppendSample(out, "game_server_http_requests_total"sv, labels, double(requests[e][c]));
+        }
+    }
+
+    AppendHelp(out, "game_server_http_request_duration_seconds"sv, "histogram"sv, "HTTP request latency."sv);
+    for (size_t e = 0; e < ENDPOINT_COUNT; ++e) {
+        if (durations[e].count == 0) {
+            continue;
+        }
+        auto labels = "endpoint=\""s + std::string(GetEndpointName(Endpoint(e))) + "\""s;
+        AppendHistogram(out, "game_server_http_request_duration_seconds"sv, labels, durations[e], MICROSECOND);
+    }
+
+    AppendHelp(out, "game_server_tick_duration_seconds"sv, "histogram"sv, "Time spent in game tick handler."sv);
+    AppendHistogram(out, "game_server_tick_duration_seconds"sv, {}, tick_durations, MICROSECOND);
+    AppendHelp(out, "game_server_tick_lag_seconds"sv, "histogram"sv, "Delay of tick start relative to schedule."sv);
+    AppendHistogram(out, "game_server_tick_lag_seconds"sv, {}, tick_lags, MICROSECOND);
+    AppendHelp(out, "game_server_tick_missed_total"sv, "counter"sv, "Ticks dropped because the simulation fell behind."sv);
+    AppendSample(out, "game_server_tick_missed_total"sv, {}, double(ticks_missed));
+
+    AppendHelp(out, "game_server_active_connections"sv, "gauge"sv, "Open HTTP connections."sv);
+    AppendSample(out, "game_server_active_connections"sv, {}, opened >= closed ? double(opened - closed) : 0.0);
+}
+
+void AppendHelp(std::string& out, std::string_view name, std::string_view type, std::string_view help) {
+    out += "# HELP "sv;
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE "sv;
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+void AppendSample(std::string& out, std::string_view name, std::string_view labels, double value) {
+    out += name;
+    if (!labels.empty()) {
+        out += MakeLabels(labels, {});
+    }
+    out += ' ';
+    AppendNumber(out, value);
+    out += '\n';
+}
+
+void AppendHistogram(std::string& out, std::string_view name, std::string_view labels,
+                     const Histogram::Snapshot& snapshot, double unit) {
+    const std::string bucket_name = std::string(name) + "_bucket"s;
+    std::uint64_t cumulative = 0;
+    for (size_t i = 0; i < Histogram::BUCKET_COUNT; ++i) {
+        cumulative += snapshot.buckets[i];
+        char le[48];
+        std::snprintf(le, sizeof(le), "le=\"%.9g\"", double(Histogram::BucketUpperBound(i)) * unit);
+        out += bucket_name;
+        out += MakeLabels(labels, le);
+        out += ' ';
+        out += std::to_string(cumulative);
+        out += '\n';
+    }
+    out += bucket_name;
+    out += MakeLabels(labels, "le=\"+Inf\""sv);
+    out += ' ';
+    out += std::to_string(snapshot.count);
+    out += '\n';
+    AppendSample(out, std::string(name) + "_sum"s, labels, double(snapshot.sum) * unit);
+    AppendSample(out, std::string(name) + "_count"s, labels, double(snapshot.count));
+}
+
+}  // namespace metrics
@@ -1,7 +1,11 @@
 #include "model.h"
 
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 
+#include "constants.h"
+
 namespace model {
 using namespace std::literals;
 
@@ -23,11 +27,66 @@ void Map::AddOffice(Office office) {
 
 void Map::AddRoad(const Road& road) {
     roads_for_test_.push_back(road); // TODO to delete
+    // дорога, перекрывающая уже добавленную на той же линии, в сет не попадает
+    const bool is_added = road.IsHorizontal()
+        ? roads_.horizontal_roads[road.GetStart().y].emplace(road).second
+        : roads_.vertical_roads[road.GetStart().x].emplace(road).second;
+    if (!is_added) {
+        return;
+    }
+    const double length = std::abs(road.IsHorizontal() ? road.GetEnd().x - road.GetStart().x
+                                                       : road.GetEnd().y - road.GetStart().y)
+                        + 2 * constants::ROAD_WIDTH;
+    sampled_roads_.push_back(road);
+    cumulative_lengths_.push_back((cumulative_lengths_.empty() ? 0.0 : cumulative_lengths_.back()) + length);
+}
+
+DogPosition Map::GetPointOnRoads(double along, double across) const {
+    if (sampled_roads_.empty()) {
+        return {0.0, 0.0};
+    }
+    const double offset = along * cumulative_lengths_.back();
+    const size_t index = std::min<size_t>(
+        std::upper_bound(cumulative_lengths_.begin(), cumulative_lengths_.end(), offset) - cumulative_lengths_.begin(),
+        sampled_roads_.size() - 1);
+    const double road_offset = offset - (index == 0 ? 0.0 : cumulative_lengths_[index - 1]);
+    const Road& road = sampled_roads_[index];
+    const double side_offset = (2 * across - 1) * constants::ROAD_WIDTH;
     if (road.IsHorizontal()) {
-        roads_.horizontal_roads[road.GetStart().y].emplace(road);
-    } else {
-        roads_.vertical_roads[road.GetStart().x].emplace(road);
+        const double min_x = std::min(road.GetStart().x, road.GetEnd().x) - constants::ROAD_WIDTH;
+        return {min_x + road_offset, road.GetStart().y + side_offset};
     }
+    const double min_y = std::min(road.GetStart().y, road.GetEnd().y) - constants::ROAD_WIDTH;
+    return {road.GetStart().x + side_offset, min_y + road_offset};
+}
+
+GameSession& Game::FindSession(const Map::Id& id) {
+    auto& shards = sessions_by_map_id_[id];
+    GameSession* least_loaded = nullptr;
+    for (auto* session : shards) {
+        if (!least_loaded || session->GetDogs().size() < least_loaded->GetDogs().size()) {
+            least_loaded = session;
+        }
+    }
+    if (least_loaded && (max_players_per_session_ <= 0
+                         || least_loaded->GetDogs().size() < size_t(max_players_per_session_))) {
+        return *least_loaded;
+    }
+    return AddSession(id);
+}
+
+GameSession& Game::AddSession(const Map::Id& id) {
+    auto& session = sessions_.emplace_back(maps_.at(map_id_to_index_.at(id)), sessions_counter_++);
+    sessions_by_map_id_[id].push_back(&session);
+    return session;
+}
+
+void Game::RemoveSession(const GameSession& session) {
+    auto& shards = sessions_by_map_id_[session.GetMap().GetId()];
+    std::erase(shards, &session);
+    sessions_.remove_if([&session](const GameSession& item) {
+        return &item == &session;
+    });
 }
 
 const Map* Game::FindMap(const Map::Id& id) const noexcept {
@@ -52,14 +111,21 @@ void Game::AddMap(Map map) {
     }
 }
 
-Dog& GameSession::AddPlayer(std::string name) {
-    dogs_.emplace_back(Dog(name, players_counter_++));
-    return dogs_.back();
+GameSession::DogHandle GameSession::AddPlayer(std::string name) {
+    return dogs_.Emplace(std::move(name), players_counter_++, size_t(std::max(0, map_.GetBagCapacity())));
 }
 
-void GameSession::AddLoot(LootState loot) {
+bool GameSession::RemoveDog(DogHandle handle) {
+    return dogs_.Erase(handle);
+}
+
+GameSession::LootHandle GameSession::AddLoot(LootState loot) {
     loot.id = loot_counter_++;
-    loot_.emplace_back(loot);
+    return loot_.Insert(std::move(loot));
+}
+
+bool GameSession::RemoveLoot(LootHandle handle) {
+    return loot_.Erase(handle);
 }
 
 }  // namespace model
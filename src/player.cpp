@@ -2,16 +2,33 @@
 
 namespace player{
 
-Player::Player(Id id, GameSession& session, Dog& dog) 
+Player::Player(Id id, GameSession& session, DogHandle dog, Dog::Id dog_id) 
         : id_(std::move(id))
         , session_(session)
         , dog_(dog) 
+        , dog_id_(dog_id)
     {}
 
-Player& Players::AddPlayer(GameSession& session, Dog& dog){
+Player& Players::AddPlayer(GameSession& session, DogHandle dog){
         Player::Id id{player_counter_++};
-        player_by_id_.emplace(id, Player(id, session, dog));
+        const auto dog_id = session.FindDog(dog)->GetId();
+        player_by_id_.emplace(id, Player(id, session, dog, dog_id));
+        player_by_dog_.emplace(DogKey{&session, dog_id}, id);
         return player_by_id_.at(id);
     }
 
+Player* Players::FindPlayerByDog(const GameSession& session, Dog::Id dog_id) {
+    if (auto it = player_by_dog_.find(DogKey{&session, dog_id}); it != player_by_dog_.end()) {
+        return &player_by_id_.at(it->second);
+    }
+    return nullptr;
+}
+
+void Players::RemovePlayer(Player::Id id) {
+    if (auto it = player_by_id_.find(id); it != player_by_id_.end()) {
+        player_by_dog_.erase(DogKey{&it->second.GetSession(), it->second.GetDogId()});
+        player_by_id_.erase(it);
+    }
+}
+
 } // namespace player
\ No newline at end of file
@@ -0,0 +1,416 @@
+#include "static_cache.h"
+
+#include <cctype>
+#include <charconv>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/crc.hpp>
+
+namespace http_handler {
+
+namespace {
+
+constexpr std::string_view GZIP_EXTENSION = ".gz"sv;
+
+void AppendLittleEndian(std::string& out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(char((value >> (8 * i)) & 0xFF));
+    }
+}
+
+// Упаковывает данные в формат gzip (RFC 1952): заголовок, deflate-поток, CRC32 и размер
+std::string GzipCompress(const std::string& data) {
+    namespace zlib = beast::zlib;
+    zlib::deflate_stream deflate;
+    deflate.reset(9, 15, 8, zlib::Strategy::normal);
+
+    std::string result = {'\x1f', '\x8b', '\x08', '\0', '\0', '\0', '\0', '\0', '\x02', '\x03'};
+    const size_t header_size = result.size();
+    result.resize(header_size + deflate.upper_bound(data.size()));
+
+    zlib::z_params params;
+    params.next_in = data.data();
+    params.avail_in = data.size();
+    params.next_out = result.data() + header_size;
+    params.avail_out = result.size() - header_size;
+    beast::error_code ec;
+    deflate.write(params, zlib::Flush::finish, ec);
+    if (ec && ec != zlib::error::end_of_stream) {
+        throw beast::system_error(ec);
+    }
+    result.resize(header_size + params.total_out);
+
+    boost::crc_32_type crc;
+    crc.process_bytes(data.data(), data.size());
+    AppendLittleEndian(result, crc.checksum());
+    AppendLittleEndian(result, std::uint32_t(data.size()));
+    return result;
+}
+
+constexpr std::string_view HTTP_DATE_FORMAT = "%a, %d %b %Y %H:%M:%S GMT"sv;
+
+std::string FormatHttpDate(std::time_t time) {
+    std::tm tm{};
+    gmtime_r(&time, &tm);
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    out << std::put_time(&tm, HTTP_DATE_FORMAT.data());
+    return out.str();
+}
+
+std::optional<std::time_t> ParseHttpDate(std::string_view date) {
+    std::tm tm{};
+    std::istringstream in{std::string(date)};
+    in.imbue(std::locale::classic());
+    in >> std::get_time(&tm, HTTP_DATE_FORMAT.data());
+    if (in.fail()) {
+        return std::nullopt;
+    }
+    return timegm(&tm);
+}
+
+// Сильный валидатор по размеру и времени изменения файла, как это делает nginx
+std::string MakeETag(std::uint64_t size, std::time_t modified) {
+    std::ostringstream out;
+    out << '"' << std::hex << modified << '-' << size << '"';
+    return out.str();
+}
+
+std::string_view TrimSpaces(std::string_view str) {
+    str.remove_prefix(std::min(str.find_first_not_of(" \t"sv), str.size()));
+    str.remove_suffix(str.size() - std::min(str.find_last_not_of(" \t"sv) + 1, str.size()));
+    return str;
+}
+
+// Слабое сравнение из RFC 7232: префикс W/ не учитывается
+bool IsETagMatched(std::string_view if_none_match, std::string_view etag) {
+    while (!if_none_match.empty()) {
+        auto tag = if_none_match.substr(0, if_none_match.find(','));
+        if_none_match.remove_prefix(std::min(if_none_match.size(), tag.size() + 1));
+        tag = TrimSpaces(tag);
+        if (tag.starts_with("W/"sv)) {
+            tag.remove_prefix(2);
+        }
+        if (tag == "*"sv || tag == etag) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Response>
+void CopyHeaders(const CachedResponse& from, Response& to) {
+    for (const auto& field : from.base()) {
+        if (field.name() != http::field::content_length) {
+            to.set(field.name(), field.value());
+        }
+    }
+}
+
+std::string MakeContentRange(std::uint64_t offset, std::uint64_t length, std::uint64_t size) {
+    return "bytes "s + std::to_string(offset) + "-"s + std::to_string(offset + length - 1) + "/"s + std::to_string(size);
+}
+
+} // namespace
+
+StaticFileCache::StaticFileCache(const fs::path& root_path, std::uint64_t max_cached_file_size)
+        : root_path_(fs::weakly_canonical(root_path))
+        , max_cached_file_size_(max_cached_file_size) {
+    error_body_ = ReadFile(root_path_ / "error.txt");
+
+    for (const auto& entry : fs::recursive_directory_iterator(root_path_)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+        StaticFile file;
+        file.path = entry.path();
+        file.size = entry.file_size();
+        file.modified = std::chrono::system_clock::to_time_t(
+            std::chrono::file_clock::to_sys(entry.last_write_time()));
+        file.response.set(http::field::content_type, GetContentType(file.path.extension().string()));
+        file.response.set(http::field::etag, MakeETag(file.size, file.modified));
+        file.response.set(http::field::last_modified, FormatHttpDate(file.modified));
+        file.response.set(http::field::accept_ranges, "bytes");
+        if (file.size <= max_cached_file_size_) {
+            file.response.body() = ReadFile(file.path);
+            file.response.content_length(file.size);
+            file.is_cached = true;
+        }
+        AddGzipVariant(file);
+        auto target = "/"s + fs::relative(file.path, root_path_).generic_string();
+        files_.emplace(std::move(target), std::move(file));
+    }
+}
+
+void StaticFileCache::AddGzipVariant(StaticFile& file) const {
+    const auto content_type = file.response[http::field::content_type];
+    if (!IsCompressible(content_type) || file.path.extension() == GZIP_EXTENSION) {
+        return;
+    }
+
+    std::shared_ptr<const std::string> compressed;
+    if (auto sibling = fs::path(file.path.string() + std::string(GZIP_EXTENSION)); fs::is_regular_file(sibling)) {
+        compressed = ReadFile(sibling);
+    } else {
+        const auto original = file.is_cached ? file.response.body() : ReadFile(file.path);
+        auto gzip = GzipCompress(*original);
+        // сжатие, не дающее заметного выигрыша, не хранится
+        if (gzip.size() * 10 > original->size() * 9) {
+            return;
+        }
+        compressed = std::make_shared<const std::string>(std::move(gzip));
+    }
+
+    file.response.set(http::field::vary, "Accept-Encoding");
+    CachedResponse& gzip_response = file.gzip_response.emplace();
+    gzip_response.set(http::field::content_type, content_type);
+    gzip_response.set(http::field::content_encoding, "gzip");
+    gzip_response.set(http::field::vary, "Accept-Encoding");
+    // у сжатого варианта свой валидатор, иначе кэши перепутают представления
+    auto etag = std::string(file.response[http::field::etag]);
+    gzip_response.set(http::field::etag, etag.insert(etag.size() - 1, "-gz"sv));
+    gzip_response.set(http::field::last_modified, file.response[http::field::last_modified]);
+    gzip_response.body() = std::move(compressed);
+    gzip_response.content_length(CachedBody::size(gzip_response.body()));
+}
+
+bool StaticFileCache::IsCompressible(std::string_view content_type) {
+    return content_type.starts_with("text/"sv)
+        || content_type == ::ContentType::APP_JSON
+        || content_type == ::ContentType::APP_XML
+        || content_type == ::ContentType::IMAGE_SVG_XML;
+}
+
+const StaticFileCache::StaticFile* StaticFileCache::Find(std::string_view target) const {
+    auto path = DecodeTarget(target);
+    if (path == "/") {
+        path = "/index.html";
+    }
+    if (auto it = files_.find(path); it != files_.end()) {
+        return &it->second;
+    }
+    return nullptr;
+}
+
+bool StaticFileCache::IsTargetInRoot(std::string_view target) {
+    auto relative = fs::path(DecodeTarget(target)).relative_path().lexically_normal();
+    return relative.empty() || *relative.begin() != "..";
+}
+
+bool StaticFileCache::IsGzipAccepted(std::string_view accept_encoding) {
+    // явно указанный gzip важнее *, поэтому решение принимается после разбора всего заголовка
+    std::optional<bool> is_gzip_accepted;
+    std::optional<bool> is_any_accepted;
+    while (!accept_encoding.empty()) {
+        auto coding = accept_encoding.substr(0, accept_encoding.find(','));
+        accept_encoding.remove_prefix(std::min(accept_encoding.size(), coding.size() + 1));
+
+        auto params = coding.find(';');
+        auto name = TrimSpaces(coding.substr(0, params));
+        std::optional<bool>* is_accepted = nullptr;
+        if (beast::iequals(name, "gzip"sv)) {
+            is_accepted = &is_gzip_accepted;
+        } else if (name == "*"sv) {
+            is_accepted = &is_any_accepted;
+        } else {
+            continue;
+        }
+        // q=0 означает явный отказ от кодировки
+        bool is_refused = false;
+        if (params != std::string_view::npos) {
+            auto q = TrimSpaces(coding.substr(params + 1));
+            is_refused = (q.starts_with("q=0"sv) || q.starts_with("Q=0"sv))
+                && q.find_first_not_of("0."sv, 2) == std::string_view::npos;
+        }
+        *is_accepted = is_accepted->value_or(false) || !is_refused;
+    }
+    return is_gzip_accepted.value_or(is_any_accepted.value_or(false));
+}
+
+bool StaticFileCache::IsNotModified(const StaticFile& file, const CachedResponse& prepared, const StringRequest& req) {
+    // If-None-Match имеет приоритет, If-Modified-Since при нём не проверяется
+    if (auto if_none_match = req[http::field::if_none_match]; !if_none_match.empty()) {
+        return IsETagMatched(if_none_match, prepared[http::field::etag]);
+    }
+    if (auto if_modified_since = req[http::field::if_modified_since]; !if_modified_since.empty()) {
+        auto since = ParseHttpDate(if_modified_since);
+        return since && file.modified <= *since;
+    }
+    return false;
+}
+
+std::optional<StaticFileCache::ByteRange> StaticFileCache::GetRequestedRange(const StaticFile& file, const StringRequest& req) {
+    auto range = req[http::field::range];
+    if (range.empty()) {
+        return std::nullopt;
+    }
+    if (auto if_range = TrimSpaces(req[http::field::if_range]); !if_range.empty()
+            && if_range != file.response[http::field::etag]
+            && if_range != file.response[http::field::last_modified]) {
+        return std::nullopt;
+    }
+    return ParseRange(range, file.size);
+}
+
+std::optional<StaticFileCache::ByteRange> StaticFileCache::ParseRange(std::string_view range, std::uint64_t size) {
+    constexpr auto UNIT = "bytes="sv;
+    range = TrimSpaces(range);
+    if (range.size() < UNIT.size() || !beast::iequals(range.substr(0, UNIT.size()), UNIT)
+            || range.find(',') != std::string_view::npos) {
+        return std::nullopt;
+    }
+    range.remove_prefix(UNIT.size());
+    const auto dash = range.find('-');
+    if (dash == std::string_view::npos) {
+        return std::nullopt;
+    }
+    auto parse_number = [](std::string_view str) -> std::optional<std::uint64_t> {
+        str = TrimSpaces(str);
+        std::uint64_t value = 0;
+        auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+        if (str.empty() || ec != std::errc{} || ptr != str.data() + str.size()) {
+            return std::nullopt;
+        }
+        return value;
+    };
+    auto first = parse_number(range.substr(0, dash));
+    auto last_str = TrimSpaces(range.substr(dash + 1));
+    auto last = parse_number(last_str);
+
+    if (!first) {
+        // bytes=-N: последние N байт
+        if (!last) {
+            return std::nullopt;
+        }
+        const auto length = std::min(*last, size);
+        return ByteRange{size - length, length};
+    }
+    if (!last_str.empty() && (!last || *last < *first)) {
+        return std::nullopt;
+    }
+    if (*first >= size) {
+        return ByteRange{};
+    }
+    // last может быть равен UINT64_MAX, поэтому сначала ограничиваем, потом прибавляем
+    const auto end = last ? std::min(*last, size - 1) + 1 : size;
+    return ByteRange{*first, end - *first};
+}
+
+CachedResponse StaticFileCache::MakeCachedResponse(const CachedResponse& prepared, unsigned version, bool keep_alive) const {
+    CachedResponse response = prepared;
+    response.version(version);
+    response.keep_alive(keep_alive);
+    return response;
+}
+
+CachedResponse StaticFileCache::MakeNotModifiedResponse(const CachedResponse& prepared, unsigned version, bool keep_alive) const {
+    CachedResponse response(http::status::not_modified, version);
+    response.keep_alive(keep_alive);
+    for (auto field : {http::field::etag, http::field::last_modified, http::field::vary}) {
+        if (auto value = prepared[field]; !value.empty()) {
+            response.set(field, value);
+        }
+    }
+    return response;
+}
+
+CachedResponse StaticFileCache::MakeCachedRangeResponse(const StaticFile& file, ByteRange range, unsigned version, bool keep_alive) const {
+    CachedResponse response(http::status::partial_content, version);
+    response.keep_alive(keep_alive);
+    CopyHeaders(file.response, response);
+    response.set(http::field::content_range, MakeContentRange(range.offset, range.length, file.size));
+    response.body() = std::make_shared<const std::string>(file.response.body()->substr(range.offset, range.length));
+    response.content_length(range.length);
+    return response;
+}
+
+std::optional<SendfileResponse> StaticFileCache::MakeSendfileResponse(const StaticFile& file, std::optional<ByteRange> range,
+                                                                      unsigned version, bool keep_alive) const {
+    SendfileResponse response(range ? http::status::partial_content : http::status::ok, version);
+    response.keep_alive(keep_alive);
+    beast::error_code ec;
+    auto& body = response.body();
+    body.file.open(file.path.c_str(), beast::file_mode::scan, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    body.size = body.file.size(ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    CopyHeaders(file.response, response);
+    if (range) {
+        if (range->offset > body.size || range->length > body.size - range->offset) {
+            return std::nullopt;
+        }
+        body.offset = range->offset;
+        body.size = range->length;
+        response.set(http::field::content_range, MakeContentRange(range->offset, range->length, file.size));
+    }
+    response.content_length(body.size);
+    return response;
+}
+
+CachedResponse StaticFileCache::MakeRangeNotSatisfiableResponse(const StaticFile& file, unsigned version, bool keep_alive) const {
+    CachedResponse response(http::status::range_not_satisfiable, version);
+    response.keep_alive(keep_alive);
+    response.set(http::field::content_range, "bytes */"s + std::to_string(file.size));
+    response.content_length(0);
+    return response;
+}
+
+CachedResponse StaticFileCache::MakeErrorResponse(http::status status, unsigned version, bool keep_alive) const {
+    CachedResponse response(status, version);
+    response.keep_alive(keep_alive);
+    response.set(http::field::content_type, ::ContentType::TEXT_PLAIN);
+    response.body() = error_body_;
+    response.content_length(CachedBody::size(error_body_));
+    return response;
+}
+
+std::string StaticFileCache::DecodeTarget(std::string_view target) {
+    target = target.substr(0, target.find('?'));
+    std::string result;
+    result.reserve(target.size());
+    for (size_t i = 0; i < target.size(); ++i) {
+        if (target[i] == '%' && i + 2 < target.size() && std::isxdigit(target[i + 1]) && std::isxdigit(target[i + 2])) {
+            result.push_back(char(std::stoi(std::string(target.substr(i + 1, 2)), nullptr, 16)));
+            i += 2;
+        } else {
+            result.push_back(target[i]);
+        }
+    }
+    return result;
+}
+
+std::shared_ptr<const std::string> StaticFileCache::ReadFile(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return std::make_shared<const std::string>();
+    }
+    return std::make_shared<const std::string>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>{});
+}
+
+std::string_view StaticFileCache::GetContentType(std::string_view file_extention) {
+    if (file_extention == ".htm" || file_extention == ".html") return ::ContentType::TEXT_HTML;
+    if (file_extention == ".css") return ::ContentType::TEXT_CSS;
+    if (file_extention == ".txt") return ::ContentType::TEXT_PLAIN;
+    if (file_extention == ".js") return ::ContentType::TEXT_JS;
+    if (file_extention == ".json") return ::ContentType::APP_JSON;
+    if (file_extention == ".xml") return ::ContentType::APP_XML;
+    if (file_extention == ".png") return ::ContentType::IMAGE_PNG;
+    if (file_extention == ".jpg" || file_extention == ".jpe" || file_extention == ".jpeg") return ::ContentType::IMAGE_JPEG;
+    if (file_extention == ".gif") return ::ContentType::IMAGE_GIF;
+    if (file_extention == ".bmp") return ::ContentType::IMAGE_BMP;
+    if (file_extention == ".ico") return ::ContentType::IMAGE_ICO;
+    if (file_extention == ".tiff" || file_extention == ".tif") return ::ContentType::IMAGE_TIFF;
+    if (file_extention == ".svg" || file_extention == ".svgz") return ::ContentType::IMAGE_SVG_XML;
+    if (file_extention == ".mp3") return ::ContentType::AUDIO_MPEG;
+    return ::ContentType::APP_OCTET_STREAM;
+}
+
+}  // namespace http_handler
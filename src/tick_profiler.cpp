@@ -0,0 +1,78 @@
+#include "tick_profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace profiling {
+
+using namespace std::literals;
+
+std::string_view GetPhaseName(TickPhase phase) noexcept {
+    switch (phase) {
+        case TickPhase::TICK: return "tick"sv;
+        case TickPhase::LOOT_GENERATION: return "loot_generation"sv;
+        case TickPhase::MOVEMENT: return "movement"sv;
+        case TickPhase::GATHERING: return "gathering"sv;
+        case TickPhase::SERIALIZATION: return "serialization"sv;
+    }
+    return "unknown"sv;
+}
+
+TickProfiler& TickProfiler::Instance() {
+    static TickProfiler profiler;
+    return profiler;
+}
+
+void TickProfiler::Record(TickPhase phase, Clock::time_point start, Clock::time_point end) noexcept {
+    auto& record = Current();
+    if (phase == TickPhase::TICK) {
+        record.start = start;
+    } else if (phase == TickPhase::SERIALIZATION) {
+        ++record.serializations;
+    }
+    record.durations[size_t(phase)] += end - start;
+}
+
+std::string TickProfiler::DumpChromeTrace(std::uint64_t max_ticks) const {
+    // тик 0 - время до первого тика, в нём бывает только сериализация
+    const std::uint64_t count = std::min({tick_ + 1, max_ticks, std::uint64_t(TICK_CAPACITY)});
+
+    std::string result;
+    result.reserve(count * PHASE_COUNT * 120 + 64);
+    result += R"({"displayTimeUnit":"ms","traceEvents":[)"sv;
+    bool is_first = true;
+    auto append_event = [&](TickPhase phase, int thread, Clock::time_point start, Clock::duration duration,
+                            const TickRecord& record) {
+        const double ts = std::chrono::duration<double, std::micro>(start - origin_).count();
+        const double dur = std::chrono::duration<double, std::micro>(duration).count();
+        char buffer[224];
+        std::snprintf(buffer, sizeof(buffer),
+                      R"(%s{"name":"%.*s","cat":"game","ph":"X","pid":1,"tid":%d,"ts":%.3f,"dur":%.3f,"args":{"tick":%llu,"count":%u}})",
+                      is_first ? "" : ",", int(GetPhaseName(phase).size()), GetPhaseName(phase).data(), thread,
+                      ts, dur, static_cast<unsigned long long>(record.tick), unsigned(record.serializations));
+        result += buffer;
+        is_first = false;
+    };
+    for (std::uint64_t tick = tick_ + 1 - count; tick <= tick_; ++tick) {
+        const TickRecord& record = ticks_[tick & MASK];
+        const auto tick_duration = record.durations[size_t(TickPhase::TICK)];
+        if (record.start != Clock::time_point{}) {
+            append_event(TickPhase::TICK, 1, record.start, tick_duration, record);
+            // суммы по сессиям показываются подряд внутри тика
+            auto phase_start = record.start;
+            for (auto phase : {TickPhase::LOOT_GENERATION, TickPhase::MOVEMENT, TickPhase::GATHERING}) {
+                append_event(phase, 1, phase_start, record.durations[size_t(phase)], record);
+                phase_start += record.durations[size_t(phase)];
+            }
+        }
+        // ответы сериализуются между тиками, их общее время - отдельной полосой после тика
+        if (record.serializations > 0) {
+            const auto start = record.start != Clock::time_point{} ? record.start + tick_duration : origin_;
+            append_event(TickPhase::SERIALIZATION, 2, start, record.durations[size_t(TickPhase::SERIALIZATION)], record);
+        }
+    }
+    result += "]}"sv;
+    return result;
+}
+
+}  // namespace profiling
@@ -1,5 +1,7 @@
 #include "ticker.h"
 
+#include "metrics.h"
+
 Ticker::Ticker(Strand& strand, std::chrono::milliseconds period, Handler handler) 
     : strand_{strand}
     , period_{period}
@@ -8,20 +10,51 @@ Ticker::Ticker(Strand& strand, std::chrono::milliseconds period, Handler handler
     {}
 
 void Ticker::Start() {
-        last_tick_ = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch());
+        last_tick_ = steady_clock::now();
+        deadline_ = last_tick_ + period_;
         ScheduleTick();
     }
 
 void Ticker::ScheduleTick() {
-    timer_.expires_after(period_);
+    timer_.expires_at(deadline_);
     timer_.async_wait(net::bind_executor(strand_, [self = shared_from_this()](sys::error_code ec){
         self->OnTick(ec);
     }));
 }
 
 void Ticker::OnTick(sys::error_code ec) {
-    auto current_tick = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch());
-    handler_(current_tick - last_tick_);
-    last_tick_ = current_tick;
+    if (ec) {
+        return;
+    }
+    const auto start = steady_clock::now();
+    const auto lag = start - deadline_;
+    accumulated_ += start - last_tick_;
+    last_tick_ = start;
+
+    int steps = 0;
+    while (accumulated_ >= period_ && steps < MAX_CATCH_UP_STEPS) {
+        handler_(period_);
+        accumulated_ -= period_;
+        ++steps;
+    }
+    std::uint64_t missed = 0;
+    if (accumulated_ >= period_) {
+        // не догоняем бесконечно: лишнее время отбрасываем, остаток меньше шага переносим
+        missed = std::uint64_t(accumulated_ / period_);
+        accumulated_ %= period_;
+    }
+
+    // следующий срок по расписанию; сроки, которые уже прошли, пропускаем
+    const auto now = steady_clock::now();
+    deadline_ += period_;
+    if (deadline_ <= now) {
+        deadline_ += period_ * ((now - deadline_) / period_ + 1);
+    }
+
+    auto& registry = metrics::Registry::Instance();
+    registry.RecordTick(now - start, lag);
+    if (missed > 0) {
+        registry.RecordMissedTicks(missed);
+    }
     ScheduleTick();
-}
\ No newline at end of file
+}
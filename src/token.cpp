@@ -21,10 +21,18 @@ Token PlayerTokens::AddPlayerToken(player::Player& player){
     key += ss.str();
     Token token{key};
     player_by_token_.emplace(token, player);
+    token_by_player_.emplace(player.GetId(), token);
     return token;
     
 }
 
+void PlayerTokens::RemovePlayerToken(player::Player::Id player_id) {
+    if (auto it = token_by_player_.find(player_id); it != token_by_player_.end()) {
+        player_by_token_.erase(it->second);
+        token_by_player_.erase(it);
+    }
+}
+
 std::optional<Token> TryExtractToken(const StringRequest& request) {
     std::stringstream ss;
     if (request.count(http::field::authorization)) {
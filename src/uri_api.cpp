@@ -28,6 +28,12 @@ UriElement& UriElement::SetProcessFunction(FunctionWithoutAuthorize func) {
     return *this;
 }
 
+UriElement& UriElement::SetProcessFunction(FunctionWithAuthorizeRequest func) {
+    process_function_with_request_ = std::move(func);
+
+    return *this;
+}
+
 UriElement& UriElement::SetContentType(std::string_view type, std::string_view error_message) {
     content_type_.need_to_check_ = true;
     content_type_.value_ = type;
@@ -47,6 +53,9 @@ http_handler::StringResponse UriElement::ProcessRequest(StringRequest req)
 
         if (authorize_.need_) {
             return security::ExecuteAuthorized(req, [&](const Token& token, std::string_view body) {
+                if (process_function_with_request_) {
+                    return process_function_with_request_(token, req);
+                }
                 return process_function_(token, body);
             });
         }
@@ -1,7 +1,81 @@
 #include "use_cases.h"
 
+#include <cctype>
+#include <charconv>
+#include <optional>
+
 namespace app {
 
+namespace {
+
+// в режиме фиксированной точки координаты держатся на сетке util::Fixed, чтобы симуляция
+// давала одинаковый результат на любых сборках, а числа в ответах были короче
+template <typename Position>
+Position Snap(Position position, bool is_fixed_point) noexcept {
+    if (is_fixed_point) {
+        position.x = util::Fixed::Quantize(position.x);
+        position.y = util::Fixed::Quantize(position.y);
+    }
+    return position;
+}
+
+std::string_view TrimSpaces(std::string_view value) noexcept {
+    constexpr std::string_view SPACES = " \t";
+    value.remove_prefix(std::min(value.find_first_not_of(SPACES), value.size()));
+    return value.substr(0, value.find_last_not_of(SPACES) + 1);
+}
+
+bool EqualsIgnoreCase(std::string_view l, std::string_view r) noexcept {
+    return std::equal(l.begin(), l.end(), r.begin(), r.end(), [](char a, char b) {
+        return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+    });
+}
+
+// вес элемента Accept по его параметрам; без q - 1, испорченный q - 0
+double GetQValue(std::string_view params) noexcept {
+    while (!params.empty()) {
+        auto param = params.substr(0, params.find(';'));
+        params.remove_prefix(std::min(params.size(), param.size() + 1));
+        param = TrimSpaces(param);
+        if (param.size() < 2 || (param[0] != 'q' && param[0] != 'Q') || param[1] != '=') {
+            continue;
+        }
+        double q = 0.0;
+        const auto value = param.substr(2);
+        const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), q);
+        if (ec != std::errc() || ptr != value.data() + value.size()) {
+            return 0.0;
+        }
+        return std::clamp(q, 0.0, 1.0);
+    }
+    return 1.0;
+}
+
+} // namespace
+
+ResponseEncoding SelectResponseEncoding(std::string_view accept) {
+    double binary_q = 0.0;
+    std::optional<double> json_q;
+    double wildcard_q = 0.0;
+    while (!accept.empty()) {
+        auto range = accept.substr(0, accept.find(','));
+        accept.remove_prefix(std::min(accept.size(), range.size() + 1));
+        const auto params = range.find(';');
+        const auto type = TrimSpaces(range.substr(0, params));
+        const double q = params == std::string_view::npos ? 1.0 : GetQValue(range.substr(params + 1));
+        if (EqualsIgnoreCase(type, ContentType::APP_OCTET_STREAM)) {
+            binary_q = std::max(binary_q, q);
+        } else if (EqualsIgnoreCase(type, ContentType::APP_JSON)) {
+            json_q = std::max(json_q.value_or(0.0), q);
+        } else if (EqualsIgnoreCase(type, "application/*"sv) || type == "*/*"sv) {
+            wildcard_q = std::max(wildcard_q, q);
+        }
+    }
+    // точное указание JSON важнее шаблонов
+    const bool is_binary = binary_q > 0.0 && (json_q ? binary_q > *json_q : binary_q >= wildcard_q);
+    return is_binary ? ResponseEncoding::BINARY : ResponseEncoding::JSON;
+}
+
 ListMapsUseCase::ListMapsUseCase(const Game::Maps& maps) {
     maps_.reserve(maps.size());
     for (const auto& map : maps) {
@@ -26,47 +100,23 @@ JoinGameResult JoinGameUseCase::JoinGame (const std::string& map_id, std::string
     }
     
     auto& session = game_->FindSession(id); 
-    auto& dog = session.AddPlayer(name);
+    auto dog_handle = session.AddPlayer(name);
+    auto& dog = *session.FindDog(dog_handle);
     if (is_position_random_) {
-        auto rnd_position = GetRandomPosition(map_id);
+        auto rnd_position = Snap(GetRandomPosition(map_id), game_->IsFixedPointCoordinates());
         dog.SetPosition(rnd_position.x, rnd_position.y);
     } else {
         dog.SetPosition(0, 0);
     }
-    auto& player = players_->AddPlayer(session, dog);
+    auto& player = players_->AddPlayer(session, dog_handle);
     auto token = player_tokens_->AddPlayerToken(player);
     return {token, *player.GetId()};
 }
 
 model::DogPosition JoinGameUseCase::GetRandomPosition(const std::string& map_id) {
     auto map = game_->FindMap(model::Map::Id(map_id));
-    auto roads = map->GetRoads();
-    auto roads_count = roads.horizontal_roads.size() + roads.vertical_roads.size();
-    auto n_road = generator_() % roads_count;
-    auto pos_x = generator_() % 101;
-    auto pos_y = generator_() % 101;
-    model::DogPosition position;
-    size_t i = 0;
-    for (auto& h_roads : roads.horizontal_roads) {
-        for (auto& road : h_roads.second) {
-            if (i == n_road) {
-                position.x = (double(road.GetEnd().x - road.GetStart().x) + 2*constants::ROAD_WIDTH)/100*pos_x + road.GetStart().x - constants::ROAD_WIDTH;
-                position.y = double(road.GetEnd().y) - constants::ROAD_WIDTH + 2*constants::ROAD_WIDTH/100*pos_y;
-            }
-            ++i;
-        }
-    }
-
-    for (auto& v_road : roads.vertical_roads) {
-        for (auto& road : v_road.second) {
-            if (i == n_road) {
-                position.y = (double(road.GetEnd().y - road.GetStart().y) + 2*constants::ROAD_WIDTH)/100*pos_y + road.GetStart().y - constants::ROAD_WIDTH;
-                position.x = double(road.GetEnd().x) - constants::ROAD_WIDTH + 2*constants::ROAD_WIDTH/100*pos_x;
-            }
-            ++i;
-        }
-    }
-    return position;
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    return map->GetPointOnRoads(dist(generator_), dist(generator_));
 }
 
 GameStateUseCase::GameStateUseCase (Game& game, PlayerTokens& player_tokens)
@@ -84,7 +134,8 @@ GameState GameStateUseCase::GetState(const Token& token) {
                 player_dog.GetPosition(),
                 player_dog.GetSpeed(),
                 player_dog.GetDirection(),
-                player_dog.GetBag()
+                player_dog.GetBag(),
+                player_dog.GetScore()
             };
             game_state.players_states.emplace_back(player_state);
         }
@@ -98,21 +149,23 @@ GameState GameStateUseCase::GetState(const Token& token) {
 }
 
 std::string SetPlayerActionUseCase::MovePlayer(const Token &token, std::string move) {
-    if (auto player = player_tokens_->FindPlayerBy(token)) {
-        auto& dog = player->GetDog();
+    auto player = player_tokens_->FindPlayerBy(token);
+    auto dog_ptr = player ? player->GetDog() : nullptr;
+    if (dog_ptr) {
+        auto& dog = *dog_ptr;
         auto dog_speed = player->GetSession().GetMap().GetDogSpeed();
         if (move == PlayerActions::MOVE_LEFT) {
             dog.SetSpeed(-dog_speed, 0.0);
-            dog.SetDirection(PlayerActions::MOVE_LEFT);
+            dog.SetDirection(model::Direction::LEFT);
         } else if (move == PlayerActions::MOVE_RIGHT) {
             dog.SetSpeed(dog_speed, 0.0);
-            dog.SetDirection(PlayerActions::MOVE_RIGHT);
+            dog.SetDirection(model::Direction::RIGHT);
         } else if (move == PlayerActions::MOVE_UP) {
             dog.SetSpeed(0.0, -dog_speed);
-            dog.SetDirection(PlayerActions::MOVE_UP);
+            dog.SetDirection(model::Direction::UP);
         } else if (move == PlayerActions::MOVE_DOWN) {
             dog.SetSpeed(0.0, dog_speed);
-            dog.SetDirection(PlayerActions::MOVE_DOWN);
+            dog.SetDirection(model::Direction::DOWN);
         } else {
             dog.SetSpeed(0.0, 0.0);
         }
@@ -122,20 +175,104 @@ std::string SetPlayerActionUseCase::MovePlayer(const Token &token, std::string m
     return "{}";
 }
 
+void SerializeGameState(const GameState& state, std::string& out) {
+    json_writer::JsonWriter writer(out);
+    writer.BeginObject().Key("players").BeginObject();
+    for (const auto& player_state : state.players_states) {
+        writer.Key(std::uint64_t(*player_state.id)).BeginObject();
+        writer.Key("pos").BeginArray().Double(player_state.position.x).Double(player_state.position.y).EndArray();
+        writer.Key("speed").BeginArray().Double(player_state.speed.vx).Double(player_state.speed.vy).EndArray();
+        writer.Key("dir").String(model::GetDirectionName(player_state.direction));
+        writer.Key("bag").BeginArray();
+        for (const auto& loot : player_state.bag) {
+            writer.BeginObject().Key("id").Int(loot.id).Key("type").Int(loot.type).EndObject();
+        }
+        writer.EndArray();
+        writer.Key("score").Int(player_state.score);
+        writer.EndObject();
+    }
+    writer.EndObject().Key("lostObjects").BeginObject();
+    for (const auto& loot_state : state.loot_states) {
+        writer.Key(std::uint64_t(loot_state.id)).BeginObject();
+        writer.Key("type").Int(loot_state.type);
+        writer.Key("pos").BeginArray().Double(loot_state.position.x).Double(loot_state.position.y).EndArray();
+        writer.EndObject();
+    }
+    writer.EndObject().EndObject();
+}
+
+void SerializeGameStateBinary(const GameState& state, std::string& out) {
+    constexpr double SCALE = BinaryFormat::SCALE;
+    size_t size = 12 + state.loot_states.size() * 14;
+    for (const auto& player_state : state.players_states) {
+        size += 27 + player_state.bag.size() * 6;
+    }
+    out.reserve(out.size() + size);
+
+    binary_writer::BinaryWriter writer(out);
+    writer.U8(BinaryFormat::VERSION).U8(BinaryFormat::GAME_STATE).U16(BinaryFormat::SCALE)
+        .U32(uint32_t(state.players_states.size())).U32(uint32_t(state.loot_states.size()));
+    for (const auto& player_state : state.players_states) {
+        writer.U32(*player_state.id)
+            .Fixed(player_state.position.x, SCALE).Fixed(player_state.position.y, SCALE)
+            .Fixed(player_state.speed.vx, SCALE).Fixed(player_state.speed.vy, SCALE)
+            .U8(uint8_t(player_state.direction))
+            .U32(uint32_t(player_state.score))
+            .U16(uint16_t(player_state.bag.size()));
+        for (const auto& loot : player_state.bag) {
+            writer.U32(uint32_t(loot.id)).U16(uint16_t(loot.type));
+        }
+    }
+    for (const auto& loot_state : state.loot_states) {
+        writer.U32(uint32_t(loot_state.id)).U16(uint16_t(loot_state.type))
+            .Fixed(loot_state.position.x, SCALE).Fixed(loot_state.position.y, SCALE);
+    }
+}
+
 UpdateGameStateUseCase::UpdateGameStateUseCase(Game& game) 
     : game_(&game) 
     , loot_generator_{TimeInterval(game_->GetLootGenPeriod()), game_->GetLootGenProbability()}                                                    
+    , dog_retirement_time_(game_->GetDogRetirementTime())
 {}
 
 
 void UpdateGameStateUseCase::Update(const std::chrono::milliseconds& delta) {
+    profiling::TickProfiler::Instance().BeginTick();
+    profiling::ScopedPhase tick_phase(profiling::TickPhase::TICK);
+    retirements_left_ = constants::MAX_RETIREMENTS_PER_TICK;
     for (auto& session : game_->GetSessions()) {
-        AddLootToSesssion(session, delta);
-        UpdateSession(session, delta);
+        {
+            profiling::ScopedPhase phase(profiling::TickPhase::LOOT_GENERATION);
+            AddLootToSesssion(session, delta);
+        }
+        {
+            profiling::ScopedPhase phase(profiling::TickPhase::MOVEMENT);
+            UpdateSession(session, delta);
+        }
+        {
+            profiling::ScopedPhase phase(profiling::TickPhase::GATHERING);
+            GatherLoot(session);
+        }
+        RetireIdleDogs(session);
     }
 }
 
-MoveDistance UpdateGameStateUseCase::FindMoveDistance(model::Roads& roads, const model::DogPosition& dog_pos, bool is_horizontal) {
+void UpdateGameStateUseCase::Advance(std::chrono::milliseconds delta, std::chrono::milliseconds max_step) {
+    if (delta.count() <= 0 || max_step.count() <= 0) {
+        return;
+    }
+    // длинный тик проходим не больше чем за MAX_TICK_SUBSTEPS шагов, расширяя шаг
+    const auto min_step = delta / constants::MAX_TICK_SUBSTEPS
+        + std::chrono::milliseconds((delta % constants::MAX_TICK_SUBSTEPS).count() != 0 ? 1 : 0);
+    max_step = std::max(max_step, min_step);
+    while (delta.count() > 0) {
+        const auto step = std::min(delta, max_step);
+        Update(step);
+        delta -= step;
+    }
+}
+
+MoveDistance UpdateGameStateUseCase::FindMoveDistance(const model::Roads& roads, const model::DogPosition& dog_pos, bool is_horizontal) {
     MoveDistance limit;
     int key_x = std::round(dog_pos.x);
     int key_y = std::round(dog_pos.y);
@@ -143,8 +280,8 @@ MoveDistance UpdateGameStateUseCase::FindMoveDistance(model::Roads& roads, const
     if (is_horizontal) {
         limit.min = key_x - constants::ROAD_WIDTH;
         limit.max = key_x + constants::ROAD_WIDTH;
-        if (roads.horizontal_roads.contains(key_y)) {
-            for(auto& road : roads.horizontal_roads[key_y]) {
+        if (auto it = roads.horizontal_roads.find(key_y); it != roads.horizontal_roads.end()) {
+            for(auto& road : it->second) {
                 double min = road.GetStart().x;
                 double max = road.GetEnd().x;
                 if (min > max) {
@@ -171,8 +308,8 @@ MoveDistance UpdateGameStateUseCase::FindMoveDistance(model::Roads& roads, const
     } else {
         limit.min = key_y - constants::ROAD_WIDTH;
         limit.max = key_y + constants::ROAD_WIDTH;
-        if (roads.vertical_roads.contains(key_x)) {
-            for(auto& road : roads.vertical_roads[key_x]) {
+        if (auto it = roads.vertical_roads.find(key_x); it != roads.vertical_roads.end()) {
+            for(auto& road : it->second) {
                 
                 double min = road.GetStart().y;
                 double max = road.GetEnd().y;
@@ -205,52 +342,41 @@ void UpdateGameStateUseCase::AddLootToSesssion(model::GameSession& session, cons
     model::LootState loot_state;
     for (int i = 0; i < loot_generator_.Generate(delta, session.GetLootCount(), session.GetPlayersCount()); ++i) {
         loot_state.type = generator_() % session.GetMap().GetLootTypes().size();
-        loot_state.position = GetRandomLootPosition(session);
+        loot_state.position = Snap(GetRandomLootPosition(session), game_->IsFixedPointCoordinates());
         session.AddLoot(loot_state);
     }
 }
 
 model::LootPosition UpdateGameStateUseCase::GetRandomLootPosition(model::GameSession& session) {
-    auto& map = session.GetMap();
-    auto roads = map.GetRoads();
-    auto roads_count = roads.horizontal_roads.size() + roads.vertical_roads.size();
-    auto n_road = generator_() % roads_count;
-    auto pos_x = generator_() % 101;
-    auto pos_y = generator_() % 101;
-    model::LootPosition position;
-    size_t i = 0;
-    for (auto& h_roads : roads.horizontal_roads) {
-        for (auto& road : h_roads.second) {
-            if (i == n_road) {
-                position.x = (double(road.GetEnd().x - road.GetStart().x) + 2*constants::ROAD_WIDTH)/100*pos_x + road.GetStart().x - constants::ROAD_WIDTH;
-                position.y = double(road.GetEnd().y) - constants::ROAD_WIDTH + 2*constants::ROAD_WIDTH/100*pos_y;
-            }
-            ++i;
-        }
-    }
-
-    for (auto& v_road : roads.vertical_roads) {
-        for (auto& road : v_road.second) {
-            if (i == n_road) {
-                position.y = (double(road.GetEnd().y - road.GetStart().y) + 2*constants::ROAD_WIDTH)/100*pos_y + road.GetStart().y - constants::ROAD_WIDTH;
-                position.x = double(road.GetEnd().x) - constants::ROAD_WIDTH + 2*constants::ROAD_WIDTH/100*pos_x;
-            }
-            ++i;
-        }
-    }
-    return position;
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    const auto point = session.GetMap().GetPointOnRoads(dist(generator_), dist(generator_));
+    return {point.x, point.y};
 }
 
 void UpdateGameStateUseCase::UpdateSession(model::GameSession& session, const std::chrono::milliseconds& delta) {
     double dt = double(delta.count()) / 1000;
-    auto roads = session.GetMap().GetRoads();
-    for (auto& dog : session.GetDogs()) {
+    const auto& roads = session.GetMap().GetRoads();
+    const bool is_fixed_point = game_->IsFixedPointCoordinates();
+    auto& dogs = session.GetDogs();
+    gathering_.Clear();
+    for (size_t i = 0; i < dogs.size(); ++i) {
+        auto& dog = dogs[i];
         auto dog_pos = dog.GetPosition();
         auto dog_speed = dog.GetSpeed();
+        if (dog_speed.vx == 0.0 && dog_speed.vy == 0.0) {
+            dog.AddIdleTime(delta);
+            // удалять посреди обхода нельзя - slot map переставляет элементы
+            if (dog_retirement_time_.count() > 0 && dog.GetIdleTime() >= dog_retirement_time_
+                && int(idle_dogs_.size()) < retirements_left_) {
+                idle_dogs_.push_back(dogs.GetHandle(i));
+            }
+        } else {
+            dog.ResetIdleTime();
+        }
         auto direction = dog.GetDirection();
         model::DogPosition new_pos = dog_pos;
         MoveDistance limit;
-        if (direction == "L" || direction == "R") {
+        if (model::IsHorizontal(direction)) {
             limit = FindMoveDistance(roads, dog_pos, true);
             new_pos.x = (dog_pos.x + (dog_speed.vx * dt));
             if (new_pos.x >= limit.max || new_pos.x <= limit.min) {
@@ -261,7 +387,7 @@ void UpdateGameStateUseCase::UpdateSession(model::GameSession& session, const st
                 }
                 dog.SetSpeed(0.0, 0.0);
             }
-        } else if (direction == "U" || direction == "D"){
+        } else {
             limit = FindMoveDistance(roads, dog_pos, false);
             new_pos.y = (dog_pos.y + (dog_speed.vy * dt));
             if (new_pos.y >= limit.max || new_pos.y <= limit.min) {
@@ -273,8 +399,91 @@ void UpdateGameStateUseCase::UpdateSession(model::GameSession& session, const st
                 dog.SetSpeed(0.0, 0.0);
             }
         }
+        if (is_fixed_point) {
+            // край дороги на сетку не попадает, поэтому вдоль движения округляем только внутрь limit
+            if (model::IsHorizontal(direction)) {
+                new_pos.x = util::Fixed::Quantize(new_pos.x, limit.min, limit.max);
+                new_pos.y = util::Fixed::Quantize(new_pos.y);
+            } else {
+                new_pos.x = util::Fixed::Quantize(new_pos.x);
+                new_pos.y = util::Fixed::Quantize(new_pos.y, limit.min, limit.max);
+            }
+        }
         dog.SetPosition(new_pos.x, new_pos.y); 
+        gathering_.gatherers.push_back({{dog_pos.x, dog_pos.y}, {new_pos.x, new_pos.y}, constants::DOG_WIDTH / 2});
+    }
+}
+
+void UpdateGameStateUseCase::GatherLoot(model::GameSession& session) {
+    auto& loot = session.GetLoot();
+    auto& dogs = session.GetDogs();
+    const auto& map = session.GetMap();
+    for (const auto& item : loot) {
+        gathering_.items.push_back({{item.position.x, item.position.y}, 0.0});
+    }
+    for (const auto& office : map.GetOffices()) {
+        const auto position = office.GetPosition();
+        gathering_.items.push_back({{double(position.x), double(position.y)}, constants::OFFICE_WIDTH / 2});
+    }
+    collision_detector::FindGatherEvents(gathering_, gathering_.events);
+
+    // события упорядочены по времени: кто раньше дошёл до предмета, тот его и подобрал
+    gathering_.is_collected.assign(loot.size(), 0);
+    const auto& loot_types = map.GetLootTypes();
+    for (const auto& event : gathering_.events) {
+        auto& dog = dogs[event.gatherer_id];
+        if (event.item_id < loot.size()) {
+            if (gathering_.is_collected[event.item_id] || !dog.AddLoot(loot[event.item_id])) {
+                continue;
+            }
+            gathering_.is_collected[event.item_id] = 1;
+            gathering_.collected.push_back(loot.GetHandle(event.item_id));
+        } else {
+            for (const auto& item : dog.GetBag()) {
+                dog.AddScore(loot_types[item.type].value);
+            }
+            dog.BagClear();
+        }
+    }
+    // дескрипторы не зависят от перестановок при удалении, поэтому удаляем уже после обхода
+    for (auto handle : gathering_.collected) {
+        session.RemoveLoot(handle);
+    }
+}
+
+void UpdateGameStateUseCase::RetireIdleDogs(model::GameSession& session) {
+    for (auto handle : idle_dogs_) {
+        retired_dogs_.push_back({&session, session.FindDog(handle)->GetId()});
+        session.RemoveDog(handle);
+    }
+    retirements_left_ -= int(idle_dogs_.size());
+    idle_dogs_.clear();
+}
+
+RetirePlayersUseCase::RetirePlayersUseCase(Game& game, Players& players, PlayerTokens& player_tokens)
+    : game_(&game)
+    , players_(&players)
+    , player_tokens_(&player_tokens)
+{}
+
+void RetirePlayersUseCase::Retire(const std::vector<RetiredDog>& retired) {
+    for (const auto& [session, dog_id] : retired) {
+        if (auto player = players_->FindPlayerByDog(*session, dog_id)) {
+            const auto id = player->GetId();
+            player_tokens_->RemovePlayerToken(id);
+            players_->RemovePlayer(id);
+        }
+        sessions_.push_back(session);
+    }
+    // одна сессия может встретиться несколько раз, а удалить её можно только однажды
+    std::sort(sessions_.begin(), sessions_.end());
+    sessions_.erase(std::unique(sessions_.begin(), sessions_.end()), sessions_.end());
+    for (auto session : sessions_) {
+        if (session->GetDogs().empty()) {
+            game_->RemoveSession(*session);
+        }
     }
+    sessions_.clear();
 }
 
 } // namespace app
\ No newline at end of file
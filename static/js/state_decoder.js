@@ -0,0 +1,96 @@
+// Разбор двоичных ответов /api/v1/game/state и /api/v1/game/players
+// (запрос с заголовком "Accept: application/octet-stream", ответ читается как ArrayBuffer).
+// Возвращает те же объекты, что и JSON-ответы, поэтому остальной код клиента не меняется.
+// Формат описан у BinaryFormat в include/use_cases.h.
+
+const BINARY_FORMAT_VERSION = 1;
+const BINARY_GAME_STATE = 1;
+const BINARY_PLAYERS_LIST = 2;
+const BINARY_DIRECTIONS = 'LRUD';
+
+class BinaryReader {
+  constructor(buffer) {
+    this.view = new DataView(buffer);
+    this.offset = 0;
+  }
+
+  u8() {
+    const value = this.view.getUint8(this.offset);
+    this.offset += 1;
+    return value;
+  }
+
+  u16() {
+    const value = this.view.getUint16(this.offset, true);
+    this.offset += 2;
+    return value;
+  }
+
+  u32() {
+    const value = this.view.getUint32(this.offset, true);
+    this.offset += 4;
+    return value;
+  }
+
+  fixed(scale) {
+    const value = this.view.getInt32(this.offset, true);
+    this.offset += 4;
+    return value / scale;
+  }
+
+  string() {
+    const length = this.u16();
+    const bytes = new Uint8Array(this.view.buffer, this.view.byteOffset + this.offset, length);
+    this.offset += length;
+    return new TextDecoder().decode(bytes);
+  }
+
+  header(expectedKind) {
+    const version = this.u8();
+    const kind = this.u8();
+    if (version != BINARY_FORMAT_VERSION || kind != expectedKind) {
+      throw new Error('Unsupported binary response: version ' + version + ', kind ' + kind);
+    }
+    return { scale: this.u16(), count: this.u32() };
+  }
+}
+
+function decodeGameState(buffer) {
+  const reader = new BinaryReader(buffer);
+  const { scale, count } = reader.header(BINARY_GAME_STATE);
+  const lootCount = reader.u32();
+
+  const players = {};
+  for (let i = 0; i < count; ++i) {
+    const id = reader.u32();
+    const pos = [reader.fixed(scale), reader.fixed(scale)];
+    const speed = [reader.fixed(scale), reader.fixed(scale)];
+    const dir = BINARY_DIRECTIONS[reader.u8()];
+    const score = reader.u32();
+    const bagSize = reader.u16();
+    const bag = [];
+    for (let j = 0; j < bagSize; ++j) {
+      bag.push({ id: reader.u32(), type: reader.u16() });
+    }
+    players[id] = { pos: pos, speed: speed, dir: dir, bag: bag, score: score };
+  }
+
+  const lostObjects = {};
+  for (let i = 0; i < lootCount; ++i) {
+    const id = reader.u32();
+    const type = reader.u16();
+    lostObjects[id] = { type: type, pos: [reader.fixed(scale), reader.fixed(scale)] };
+  }
+  return { players: players, lostObjects: lostObjects };
+}
+
+function decodePlayersList(buffer) {
+  const reader = new BinaryReader(buffer);
+  const { count } = reader.header(BINARY_PLAYERS_LIST);
+  const players = {};
+  for (let i = 0; i < count; ++i) {
+    const id = reader.u32();
+    players[id] = { name: reader.string() };
+  }
+  return players;
+}
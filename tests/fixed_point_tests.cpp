@@ -0,0 +1,47 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <catch2/catch_test_macros.hpp>
+
+#include "fixed_point.h"
+
+using util::Fixed;
+
+SCENARIO("Fixed point numbers") {
+    constexpr double STEP = 1.0 / Fixed::SCALE;
+
+    WHEN("a double is converted") {
+        THEN("it is rounded to the nearest grid point") {
+            CHECK(Fixed::FromDouble(1.5).GetRaw() == 1536);
+            CHECK(Fixed::FromDouble(-2.0).GetRaw() == -2048);
+            CHECK(Fixed::FromDouble(0.4).GetRaw() == 410);
+            CHECK(Fixed::FromDouble(-0.4).GetRaw() == -410);
+            CHECK(Fixed::FromDouble(STEP * 0.49).GetRaw() == 0);
+            CHECK(Fixed::FromDouble(STEP * 0.5).GetRaw() == 1);
+            CHECK(Fixed::FromDouble(-STEP * 0.5).GetRaw() == -1);
+            CHECK(Fixed::FromDouble(1.5).ToDouble() == 1.5);
+        }
+
+        THEN("values out of range are clamped and NaN becomes zero") {
+            CHECK(Fixed::FromDouble(1e12).GetRaw() == std::numeric_limits<std::int32_t>::max());
+            CHECK(Fixed::FromDouble(-1e12).GetRaw() == std::numeric_limits<std::int32_t>::min());
+            CHECK(Fixed::FromDouble(INFINITY).GetRaw() == std::numeric_limits<std::int32_t>::max());
+            CHECK(Fixed::FromDouble(NAN).GetRaw() == 0);
+        }
+    }
+
+    WHEN("a road edge is quantized") {
+        THEN("the nearest grid point lies outside the road") {
+            CHECK(Fixed::Quantize(0.4) > 0.4);
+            CHECK(Fixed::Quantize(-0.4) < -0.4);
+        }
+
+        THEN("quantizing within the road keeps the point inside") {
+            CHECK(Fixed::Quantize(0.4, -0.4, 0.4) == 409 * STEP);
+            CHECK(Fixed::Quantize(-0.4, -0.4, 0.4) == -409 * STEP);
+            CHECK(Fixed::Quantize(10.4, 9.6, 10.4) == 10649 * STEP);
+            CHECK(Fixed::Quantize(0.1, -0.4, 0.4) == Fixed::Quantize(0.1));
+            CHECK(Fixed::Quantize(0.5, -0.5, 0.5) == 0.5);
+        }
+    }
+}
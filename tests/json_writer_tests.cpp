@@ -0,0 +1,49 @@
+#include <cmath>
+#include <limits>
+#include <catch2/catch_test_macros.hpp>
+
+#include "json_writer.h"
+
+using namespace std::literals;
+
+SCENARIO("Streaming JSON writer") {
+    using json_writer::JsonWriter;
+
+    GIVEN("an empty output string") {
+        std::string out;
+        JsonWriter writer(out);
+
+        WHEN("nested objects and arrays are written") {
+            writer.BeginObject()
+                .Key("pos").BeginArray().Double(1.5).Double(0.1).Int(-3).EndArray()
+                .Key(std::uint64_t(7)).BeginObject().EndObject()
+                .Key("empty").BeginArray().EndArray()
+                .Key("flag").Bool(true)
+                .Key("nothing").Null()
+                .EndObject();
+
+            THEN("commas and colons are placed between items") {
+                CHECK(out == R"({"pos":[1.5,0.1,-3],"7":{},"empty":[],"flag":true,"nothing":null})"s);
+            }
+        }
+
+        WHEN("a string with special characters is written") {
+            writer.String("a\"b\\c\nd\x01");
+
+            THEN("they are escaped") {
+                CHECK(out == R"("a\"b\\c\nd\u0001")"s);
+            }
+        }
+
+        WHEN("a non-finite number is written") {
+            writer.BeginArray()
+                .Double(std::numeric_limits<double>::infinity())
+                .Double(std::nan(""))
+                .EndArray();
+
+            THEN("it becomes null") {
+                CHECK(out == "[null,null]"s);
+            }
+        }
+    }
+}
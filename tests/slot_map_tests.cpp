@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+
+#include "slot_map.h"
+
+using namespace std::literals;
+
+SCENARIO("Slot map") {
+    using Map = util::SlotMap<std::string>;
+
+    GIVEN("a slot map with several values") {
+        Map map;
+        const auto a = map.Insert("a"s);
+        const auto b = map.Insert("b"s);
+        const auto c = map.Insert("c"s);
+
+        THEN("values are found by handles and iterated densely") {
+            REQUIRE(map.size() == 3);
+            CHECK(*map.Find(a) == "a"s);
+            CHECK(*map.Find(b) == "b"s);
+            CHECK(*map.Find(c) == "c"s);
+            CHECK(std::vector<std::string>(map.begin(), map.end()) == std::vector{"a"s, "b"s, "c"s});
+        }
+
+        WHEN("a value in the middle is erased") {
+            REQUIRE(map.Erase(a));
+
+            THEN("its handle becomes stale and other handles stay valid") {
+                CHECK(map.size() == 2);
+                CHECK(map.Find(a) == nullptr);
+                CHECK_FALSE(map.Erase(a));
+                CHECK(*map.Find(b) == "b"s);
+                CHECK(*map.Find(c) == "c"s);
+            }
+
+            AND_WHEN("a new value reuses the slot") {
+                const auto d = map.Insert("d"s);
+
+                THEN("the old handle still finds nothing") {
+                    CHECK(d.index == a.index);
+                    CHECK_FALSE(d == a);
+                    CHECK(map.Find(a) == nullptr);
+                    CHECK(*map.Find(d) == "d"s);
+                }
+            }
+        }
+
+        WHEN("handles are taken by dense position") {
+            THEN("they point back to the same values") {
+                for (size_t i = 0; i < map.size(); ++i) {
+                    CHECK(map.Find(map.GetHandle(i)) == &map[i]);
+                }
+            }
+        }
+
+        WHEN("all values are erased") {
+            map.Erase(c);
+            map.Erase(a);
+            map.Erase(b);
+
+            THEN("the map is empty") {
+                CHECK(map.empty());
+                CHECK(map.begin() == map.end());
+            }
+        }
+    }
+}
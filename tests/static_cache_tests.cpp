@@ -0,0 +1,167 @@
+#include <cstdint>
+#include <string>
+#include <catch2/catch_test_macros.hpp>
+
+#include "static_cache.h"
+
+using namespace std::literals;
+using http_handler::StaticFileCache;
+
+namespace {
+
+using ByteRange = StaticFileCache::ByteRange;
+
+constexpr std::string_view ETAG = R"("5e-64")"sv;
+constexpr std::string_view LAST_MODIFIED = "Sun, 06 Nov 1994 08:49:37 GMT"sv;
+constexpr std::time_t MODIFIED = 784111777;
+
+StaticFileCache::StaticFile MakeFile() {
+    StaticFileCache::StaticFile file;
+    file.size = 100;
+    file.modified = MODIFIED;
+    file.response.set(http_handler::http::field::etag, ETAG);
+    file.response.set(http_handler::http::field::last_modified, LAST_MODIFIED);
+    return file;
+}
+
+}  // namespace
+
+SCENARIO("Range header parsing") {
+    GIVEN("a file of 100 bytes") {
+        constexpr std::uint64_t SIZE = 100;
+
+        WHEN("a closed range is requested") {
+            THEN("it is clamped to the file") {
+                CHECK(StaticFileCache::ParseRange("bytes=0-9"sv, SIZE) == ByteRange{0, 10});
+                CHECK(StaticFileCache::ParseRange(" Bytes=10-10 "sv, SIZE) == ByteRange{10, 1});
+                CHECK(StaticFileCache::ParseRange("bytes=90-200"sv, SIZE) == ByteRange{90, 10});
+            }
+        }
+
+        WHEN("an open-ended or a suffix range is requested") {
+            THEN("it reaches the end of the file") {
+                CHECK(StaticFileCache::ParseRange("bytes=95-"sv, SIZE) == ByteRange{95, 5});
+                CHECK(StaticFileCache::ParseRange("bytes=-10"sv, SIZE) == ByteRange{90, 10});
+                CHECK(StaticFileCache::ParseRange("bytes=-500"sv, SIZE) == ByteRange{0, 100});
+            }
+        }
+
+        WHEN("the last byte position is the largest possible number") {
+            const auto range = StaticFileCache::ParseRange("bytes=5-18446744073709551615"sv, SIZE);
+
+            THEN("the range ends with the file instead of overflowing") {
+                CHECK(range == ByteRange{5, 95});
+            }
+        }
+
+        WHEN("the range starts after the file") {
+            THEN("it is not satisfiable") {
+                CHECK(StaticFileCache::ParseRange("bytes=100-"sv, SIZE) == ByteRange{});
+                CHECK(StaticFileCache::ParseRange("bytes=150-160"sv, SIZE) == ByteRange{});
+            }
+        }
+
+        WHEN("the header is invalid or asks for several ranges") {
+            THEN("the whole file is sent") {
+                CHECK_FALSE(StaticFileCache::ParseRange("bytes=10-5"sv, SIZE));
+                CHECK_FALSE(StaticFileCache::ParseRange("bytes=0-1,5-6"sv, SIZE));
+                CHECK_FALSE(StaticFileCache::ParseRange("bytes=-"sv, SIZE));
+                CHECK_FALSE(StaticFileCache::ParseRange("bytes=a-b"sv, SIZE));
+                CHECK_FALSE(StaticFileCache::ParseRange("items=0-1"sv, SIZE));
+                CHECK_FALSE(StaticFileCache::ParseRange("bytes=18446744073709551616-"sv, SIZE));
+            }
+        }
+    }
+}
+
+SCENARIO("Conditional requests") {
+    using http_handler::http::field;
+
+    GIVEN("a file with an ETag and a modification date") {
+        const auto file = MakeFile();
+        http_handler::StringRequest req;
+
+        WHEN("If-None-Match lists the ETag") {
+            THEN("the file is not modified, weak tags compare equal") {
+                req.set(field::if_none_match, R"("other", "5e-64")"sv);
+                CHECK(StaticFileCache::IsNotModified(file, file.response, req));
+                req.set(field::if_none_match, R"(W/"5e-64")"sv);
+                CHECK(StaticFileCache::IsNotModified(file, file.response, req));
+                req.set(field::if_none_match, "*"sv);
+                CHECK(StaticFileCache::IsNotModified(file, file.response, req));
+            }
+        }
+
+        WHEN("If-None-Match lists other tags") {
+            req.set(field::if_none_match, R"("other", W/"5e-65")"sv);
+            req.set(field::if_modified_since, LAST_MODIFIED);
+
+            THEN("the file is sent and the date is not checked") {
+                CHECK_FALSE(StaticFileCache::IsNotModified(file, file.response, req));
+            }
+        }
+
+        WHEN("only If-Modified-Since is sent") {
+            THEN("the file is not modified since its own date") {
+                req.set(field::if_modified_since, LAST_MODIFIED);
+                CHECK(StaticFileCache::IsNotModified(file, file.response, req));
+                req.set(field::if_modified_since, "Sun, 06 Nov 1994 08:49:36 GMT"sv);
+                CHECK_FALSE(StaticFileCache::IsNotModified(file, file.response, req));
+                req.set(field::if_modified_since, "yesterday"sv);
+                CHECK_FALSE(StaticFileCache::IsNotModified(file, file.response, req));
+            }
+        }
+
+        WHEN("a range is requested with If-Range") {
+            req.set(field::range, "bytes=0-9"sv);
+
+            THEN("the range is used only when the ETag or the date matches") {
+                CHECK(StaticFileCache::GetRequestedRange(file, req) == ByteRange{0, 10});
+                req.set(field::if_range, ETAG);
+                CHECK(StaticFileCache::GetRequestedRange(file, req) == ByteRange{0, 10});
+                req.set(field::if_range, LAST_MODIFIED);
+                CHECK(StaticFileCache::GetRequestedRange(file, req) == ByteRange{0, 10});
+                req.set(field::if_range, R"("other")"sv);
+                CHECK_FALSE(StaticFileCache::GetRequestedRange(file, req));
+                req.set(field::if_range, "Mon, 07 Nov 1994 08:49:37 GMT"sv);
+                CHECK_FALSE(StaticFileCache::GetRequestedRange(file, req));
+            }
+        }
+    }
+}
+
+SCENARIO("Accept-Encoding parsing") {
+    WHEN("gzip is listed") {
+        THEN("it is accepted in any case and with any positive q") {
+            CHECK(StaticFileCache::IsGzipAccepted("gzip"sv));
+            CHECK(StaticFileCache::IsGzipAccepted("deflate, GZip"sv));
+            CHECK(StaticFileCache::IsGzipAccepted("br, gzip;q=0.5"sv));
+            CHECK(StaticFileCache::IsGzipAccepted("gzip; q=0.01"sv));
+        }
+    }
+
+    WHEN("gzip is refused with q=0") {
+        THEN("it is not accepted even with the wildcard") {
+            CHECK_FALSE(StaticFileCache::IsGzipAccepted("gzip;q=0"sv));
+            CHECK_FALSE(StaticFileCache::IsGzipAccepted("gzip; q=0.000"sv));
+            CHECK_FALSE(StaticFileCache::IsGzipAccepted("gzip;q=0, *"sv));
+            CHECK_FALSE(StaticFileCache::IsGzipAccepted("*, GZIP;Q=0"sv));
+        }
+    }
+
+    WHEN("only the wildcard matches") {
+        THEN("its q decides") {
+            CHECK(StaticFileCache::IsGzipAccepted("*"sv));
+            CHECK(StaticFileCache::IsGzipAccepted("br, *;q=0.1"sv));
+            CHECK_FALSE(StaticFileCache::IsGzipAccepted("*;q=0"sv));
+        }
+    }
+
+    WHEN("gzip is not mentioned") {
+        THEN("it is not accepted") {
+            CHECK_FALSE(StaticFileCache::IsGzipAccepted(""sv));
+            CHECK_FALSE(StaticFileCache::IsGzipAccepted("deflate, br"sv));
+            CHECK_FALSE(StaticFileCache::IsGzipAccepted("x-gzip2"sv));
+        }
+    }
+}
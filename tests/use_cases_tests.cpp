@@ -0,0 +1,349 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+
+#include "use_cases.h"
+
+using namespace std::literals;
+
+namespace {
+
+// карта с одной горизонтальной дорогой от (0, 0) до (10, 0)
+model::Map MakeMap() {
+    model::Map map(model::Map::Id("map1"s), "Map 1"s);
+    map.AddRoad(model::Road(model::Road::HORIZONTAL, {0, 0}, 10));
+    map.SetDogSpeed(1.0);
+    map.SetBagCapacity(3);
+    return map;
+}
+
+// трофеи сами не появляются, их раскладывают тесты
+model::Game MakeGame(model::Map map = MakeMap()) {
+    model::Game game;
+    game.AddMap(std::move(map));
+    game.SetLootGenPeriod(1000);
+    game.SetLootGenProbability(0.0);
+    return game;
+}
+
+// собака, бегущая вправо; ссылки на собак меняются при добавлении новых, поэтому возвращается дескриптор
+model::GameSession::DogHandle AddMovingDog(model::GameSession& session, double x) {
+    const auto handle = session.AddPlayer("dog"s);
+    auto& dog = *session.FindDog(handle);
+    dog.SetPosition(x, 0.0);
+    dog.SetDirection(model::Direction::RIGHT);
+    dog.SetSpeed(1.0, 0.0);
+    return handle;
+}
+
+std::vector<std::uint8_t> ToBytes(const std::string& data) {
+    return {data.begin(), data.end()};
+}
+
+}  // namespace
+
+SCENARIO("Manual tick") {
+    GIVEN("a game with a moving dog") {
+        auto game = MakeGame();
+        auto& session = game.FindSession(model::Map::Id("map1"s));
+        auto& dog = *session.FindDog(AddMovingDog(session, 0.0));
+        app::UpdateGameStateUseCase update(game);
+
+        WHEN("the tick or the step is not positive") {
+            update.Advance(0ms, 1ms);
+            update.Advance(1000ms, 0ms);
+            update.Advance(1000ms, -1ms);
+
+            THEN("the game does not change") {
+                CHECK(dog.GetPosition().x == 0.0);
+            }
+        }
+
+        WHEN("the tick fits into the substep limit") {
+            update.Advance(std::chrono::milliseconds(constants::MAX_TICK_SUBSTEPS), 1ms);
+
+            THEN("the dog moves the whole delta") {
+                CHECK(std::abs(dog.GetPosition().x - 10.0) < 1e-6);
+            }
+        }
+
+        WHEN("an hour passes with the default step") {
+            auto& idle_dog = *session.FindDog(session.AddPlayer("idle"s));
+            idle_dog.SetPosition(5.0, 0.0);
+            update.Advance(1h, std::chrono::milliseconds(constants::DEFAULT_MAX_TICK_STEP));
+
+            THEN("the whole hour is simulated in wider steps") {
+                CHECK(idle_dog.GetIdleTime() == 1h);
+                CHECK(session.FindDog(session.GetDogs().GetHandle(0))->GetPosition().x == 10.0 + constants::ROAD_WIDTH);
+            }
+        }
+
+        WHEN("the tick is as long as possible") {
+            update.Advance(std::chrono::milliseconds::max(), 1ms);
+
+            THEN("it still finishes and the dog stops at the end of the road") {
+                CHECK(dog.GetPosition().x == 10.0 + constants::ROAD_WIDTH);
+            }
+        }
+    }
+}
+
+SCENARIO("Retirement of idle players") {
+    GIVEN("a game where dogs retire after a second without moving") {
+        auto game = MakeGame();
+        game.SetDogRetirementTime(1000);
+        app::Players players;
+        app::PlayerTokens tokens;
+        app::JoinGameUseCase join(game, players, tokens, false);
+        app::UpdateGameStateUseCase update(game);
+        app::RetirePlayersUseCase retire(game, players, tokens);
+        app::GameStateUseCase state(game, tokens);
+        auto tick = [&](std::chrono::milliseconds delta) {
+            update.Update(delta);
+            auto retired = update.TakeRetiredDogs();
+            retire.Retire(retired);
+            return retired.size();
+        };
+
+        const auto joined = join.JoinGame("map1"s, "idle"s);
+        auto* session = &tokens.FindPlayerBy(joined.token)->GetSession();
+
+        WHEN("the dog stands still for less than the timeout") {
+            THEN("the player stays in the game") {
+                CHECK(tick(999ms) == 0);
+                CHECK(tokens.FindPlayerBy(joined.token) != nullptr);
+                CHECK(session->GetPlayersCount() == 1);
+            }
+        }
+
+        WHEN("the dog moves before the timeout") {
+            tick(900ms);
+            tokens.FindPlayerBy(joined.token)->GetDog()->SetSpeed(1.0, 0.0);
+            tokens.FindPlayerBy(joined.token)->GetDog()->SetDirection(model::Direction::RIGHT);
+            tick(200ms);
+
+            THEN("its idle time starts over") {
+                CHECK(tokens.FindPlayerBy(joined.token)->GetDog()->GetIdleTime() == 0ms);
+                CHECK(tick(1000ms) == 0);
+            }
+        }
+
+        WHEN("the dog stands still for the whole timeout") {
+            REQUIRE(tick(1000ms) == 1);
+
+            THEN("its token is revoked, so state requests get 401") {
+                CHECK(tokens.FindPlayerBy(joined.token) == nullptr);
+                CHECK_THROWS_AS(state.GetState(joined.token), app::GameStateError);
+            }
+
+            THEN("the empty session is removed") {
+                CHECK(game.GetSessions().empty());
+            }
+
+            AND_WHEN("another player joins the map") {
+                const auto next = join.JoinGame("map1"s, "next"s);
+
+                THEN("a new session is opened for it") {
+                    REQUIRE(game.GetSessions().size() == 1);
+                    CHECK(game.GetSessions().front().GetPlayersCount() == 1);
+                    CHECK(&tokens.FindPlayerBy(next.token)->GetSession() == &game.GetSessions().front());
+                }
+            }
+        }
+
+        WHEN("more dogs than MAX_RETIREMENTS_PER_TICK time out together") {
+            for (int i = 1; i < constants::MAX_RETIREMENTS_PER_TICK + 10; ++i) {
+                join.JoinGame("map1"s, "idle"s + std::to_string(i));
+            }
+
+            THEN("they are retired over several ticks") {
+                CHECK(tick(1000ms) == size_t(constants::MAX_RETIREMENTS_PER_TICK));
+                CHECK(session->GetPlayersCount() == 10);
+                CHECK(tick(1ms) == 10);
+                CHECK(game.GetSessions().empty());
+            }
+        }
+    }
+}
+
+SCENARIO("Loot gathering") {
+    GIVEN("a map with an office at the end of the road and bags for one item") {
+        auto map = MakeMap();
+        map.SetBagCapacity(1);
+        model::LootType cheap;
+        cheap.value = 10;
+        model::LootType expensive;
+        expensive.value = 30;
+        map.AddLootType(cheap);
+        map.AddLootType(expensive);
+        map.AddOffice(model::Office(model::Office::Id("o1"s), {10, 0}, {0, 0}));
+        auto game = MakeGame(std::move(map));
+        auto& session = game.FindSession(model::Map::Id("map1"s));
+        app::UpdateGameStateUseCase update(game);
+
+        WHEN("two dogs run over the same item") {
+            const auto first_handle = AddMovingDog(session, 4.0);
+            const auto second_handle = AddMovingDog(session, 7.0);
+            auto& first = *session.FindDog(first_handle);
+            auto& second = *session.FindDog(second_handle);
+            second.SetDirection(model::Direction::LEFT);
+            second.SetSpeed(-1.0, 0.0);
+            session.AddLoot({0, 0, {5.0, 0.0}});
+            update.Update(3000ms);
+
+            THEN("the dog that reaches it earlier takes it") {
+                CHECK(session.GetLootCount() == 0);
+                REQUIRE(first.GetBag().size() == 1);
+                CHECK(first.GetBag()[0].type == 0);
+                CHECK(second.GetBag().empty());
+            }
+        }
+
+        WHEN("a dog with a full bag runs over an item") {
+            auto& dog = *session.FindDog(AddMovingDog(session, 0.0));
+            session.AddLoot({0, 0, {2.0, 0.0}});
+            session.AddLoot({0, 1, {4.0, 0.0}});
+            update.Update(5000ms);
+
+            THEN("the item stays on the map") {
+                REQUIRE(dog.GetBag().size() == 1);
+                CHECK(dog.GetBag()[0].type == 0);
+                REQUIRE(session.GetLootCount() == 1);
+                CHECK(session.GetLoot()[0].type == 1);
+                CHECK(session.GetLoot()[0].position.x == 4.0);
+            }
+        }
+
+        WHEN("a dog with loot passes the office") {
+            auto& dog = *session.FindDog(AddMovingDog(session, 8.0));
+            REQUIRE(dog.AddLoot({7, 1, {0.0, 0.0}}));
+            update.Update(3000ms);
+
+            THEN("the loot value is added to the score and the bag is emptied") {
+                CHECK(dog.GetScore() == 30);
+                CHECK(dog.GetBag().empty());
+            }
+        }
+    }
+}
+
+SCENARIO("Response encoding") {
+    using app::ResponseEncoding;
+    using app::SelectResponseEncoding;
+
+    WHEN("the client does not ask for binary explicitly") {
+        THEN("JSON is sent") {
+            CHECK(SelectResponseEncoding(""sv) == ResponseEncoding::JSON);
+            CHECK(SelectResponseEncoding("*/*"sv) == ResponseEncoding::JSON);
+            CHECK(SelectResponseEncoding("application/json, application/*;q=0.8"sv) == ResponseEncoding::JSON);
+            CHECK(SelectResponseEncoding("application/octet-streamx"sv) == ResponseEncoding::JSON);
+        }
+    }
+
+    WHEN("binary is accepted") {
+        THEN("binary is sent unless JSON is preferred") {
+            CHECK(SelectResponseEncoding("application/octet-stream"sv) == ResponseEncoding::BINARY);
+            CHECK(SelectResponseEncoding("Application/Octet-Stream ; q=0.5"sv) == ResponseEncoding::BINARY);
+            CHECK(SelectResponseEncoding("application/octet-stream, */*"sv) == ResponseEncoding::BINARY);
+            CHECK(SelectResponseEncoding("application/json;q=0.9, application/octet-stream"sv) == ResponseEncoding::BINARY);
+            CHECK(SelectResponseEncoding("application/json, application/octet-stream"sv) == ResponseEncoding::JSON);
+            CHECK(SelectResponseEncoding("application/octet-stream;q=0.5, application/json"sv) == ResponseEncoding::JSON);
+        }
+    }
+
+    WHEN("binary is refused with q=0") {
+        THEN("JSON is sent") {
+            CHECK(SelectResponseEncoding("application/octet-stream;q=0"sv) == ResponseEncoding::JSON);
+            CHECK(SelectResponseEncoding("application/octet-stream; q=0.000, */*"sv) == ResponseEncoding::JSON);
+            CHECK(SelectResponseEncoding("application/octet-stream;q=oops"sv) == ResponseEncoding::JSON);
+        }
+    }
+}
+
+SCENARIO("Binary game state") {
+    GIVEN("a state with one player and one lost object") {
+        app::GameState state;
+        state.players_states.push_back({
+            player::Dog::Id(7), {1.5, -2.0}, {0.0, -1.0}, model::Direction::DOWN, {}, 42});
+        state.loot_states.push_back({3, 2, {0.25, 4.0}});
+
+        WHEN("it is serialized") {
+            std::string out;
+            app::SerializeGameStateBinary(state, out);
+
+            THEN("the header, the player and the object take 12, 27 and 14 bytes") {
+                const std::vector<std::uint8_t> expected = {
+                    // версия, вид ответа, scale = 1024, игроков, предметов
+                    0x01, 0x01, 0x00, 0x04, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+                    // id, x = 1.5, y = -2, vx = 0, vy = -1, направление D, очки, пустой рюкзак
+                    0x07, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0xF8, 0xFF, 0xFF,
+                    0x00, 0x00, 0x00, 0x00, 0x00, 0xFC, 0xFF, 0xFF, 0x03, 0x2A, 0x00, 0x00, 0x00, 0x00, 0x00,
+                    // id, тип, x = 0.25, y = 4
+                    0x03, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00,
+                };
+                CHECK(out.size() == 12 + 27 + 14);
+                CHECK(ToBytes(out) == expected);
+            }
+        }
+
+        WHEN("the player carries an item") {
+            const model::BagItem bag[] = {{5, 1}};
+            state.players_states.front().bag = bag;
+            std::string out;
+            app::SerializeGameStateBinary(state, out);
+
+            THEN("the item takes 6 more bytes after the bag size") {
+                REQUIRE(out.size() == 12 + 27 + 6 + 14);
+                const auto bytes = ToBytes(out);
+                CHECK(std::vector(bytes.begin() + 37, bytes.begin() + 45)
+                      == std::vector<std::uint8_t>{0x01, 0x00, 0x05, 0x00, 0x00, 0x00, 0x01, 0x00});
+            }
+        }
+    }
+
+    GIVEN("a session with one player") {
+        auto game = MakeGame();
+        app::Players players;
+        app::PlayerTokens tokens;
+        app::JoinGameUseCase join(game, players, tokens, false);
+        const auto joined = join.JoinGame("map1"s, "Rex"s);
+
+        WHEN("the players list is serialized") {
+            std::string out;
+            app::ListPlayersUseCase(tokens).GetPlayersListBinary(*tokens.FindPlayerBy(joined.token), out);
+
+            THEN("it holds the header, the id and the length-prefixed name") {
+                const std::vector<std::uint8_t> expected = {
+                    0x01, 0x02, 0x00, 0x04, 0x01, 0x00, 0x00, 0x00,
+                    0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 'R', 'e', 'x',
+                };
+                CHECK(ToBytes(out) == expected);
+            }
+        }
+    }
+}
+
+SCENARIO("Fixed point coordinates") {
+    GIVEN("a game on the fixed point grid") {
+        auto game = MakeGame();
+        game.SetFixedPointCoordinates(true);
+        auto& session = game.FindSession(model::Map::Id("map1"s));
+        auto& dog = *session.FindDog(AddMovingDog(session, 9.0));
+        app::UpdateGameStateUseCase update(game);
+
+        WHEN("the dog runs into the end of the road") {
+            update.Update(3000ms);
+
+            THEN("it stops on the grid, inside the road") {
+                const double x = dog.GetPosition().x;
+                CHECK(x <= 10.0 + constants::ROAD_WIDTH);
+                CHECK(x > 10.0 + constants::ROAD_WIDTH - 1.0 / util::Fixed::SCALE);
+                CHECK(x == util::Fixed::Quantize(x));
+                CHECK(dog.GetSpeed().vx == 0.0);
+            }
+        }
+    }
+}